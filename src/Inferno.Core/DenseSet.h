@@ -0,0 +1,216 @@
+#pragma once
+
+#include <bit>
+#include "Types.h"
+#include "Utility.h"
+
+namespace Inferno {
+    // Maps a value to a dense index and back. Specialize for each type stored in a DenseSet.
+    template<class T>
+    struct DenseIndex {
+        // Negative ids like SegID::None have no index
+        static constexpr bool IsValid(T value) { return (int64)value >= 0; }
+        static constexpr size_t ToIndex(T value) { return (size_t)value; }
+        static constexpr T FromIndex(size_t index) { return T(index); }
+    };
+
+    // Segment sides are indexed as segment * 6 + side, which preserves the ordering of Tag
+    template<>
+    struct DenseIndex<Tag> {
+        static constexpr bool IsValid(Tag tag) { return (int64)tag.Segment >= 0 && (int64)tag.Side >= 0 && (int64)tag.Side < 6; }
+        static constexpr size_t ToIndex(Tag tag) { return (size_t)tag.Segment * 6 + (size_t)tag.Side; }
+        static constexpr Tag FromIndex(size_t index) { return { SegID(index / 6), SideID(index % 6) }; }
+    };
+
+    // Set of ids backed by a bit array. Grows to fit the largest id inserted.
+    // Clearing only bumps a generation counter instead of touching the words, so the
+    // set can be cleared and reused for each search without reallocating.
+    // Iterates in ascending order like std::set.
+    template<class T>
+    class DenseSet {
+        List<uint64> _words;
+        List<uint32> _generations; // A word is only valid if its generation matches the set
+        uint32 _generation = 1;
+        size_t _count = 0;
+        size_t _endWord = 0; // One past the highest word written since the last clear
+
+        uint64 GetWord(size_t word) const {
+            return word < _words.size() && _generations[word] == _generation ? _words[word] : 0;
+        }
+
+        // Returns the first set index at or after index
+        size_t FindNext(size_t index) const {
+            auto word = index / 64;
+            if (word >= _endWord) return End();
+
+            auto bits = GetWord(word) & (~0ULL << (index % 64));
+
+            while (bits == 0) {
+                if (++word >= _endWord) return End();
+                bits = GetWord(word);
+            }
+
+            return word * 64 + std::countr_zero(bits);
+        }
+
+        size_t End() const { return _endWord * 64; }
+
+        static constexpr size_t MAX_INDEX = 1u << 30;
+
+        // Returns false for ids that can't be stored, so they are never used to index the words
+        static bool IsStorable(T value) {
+            return DenseIndex<T>::IsValid(value) && DenseIndex<T>::ToIndex(value) < MAX_INDEX;
+        }
+
+    public:
+        class Iterator {
+            const DenseSet* _set = nullptr;
+            size_t _index = 0;
+            T _value{};
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            Iterator() = default;
+
+            Iterator(const DenseSet* set, size_t index) : _set(set), _index(index) {
+                if (_index < _set->End())
+                    _value = DenseIndex<T>::FromIndex(_index);
+            }
+
+            const T& operator*() const { return _value; }
+            const T* operator->() const { return &_value; }
+
+            Iterator& operator++() {
+                _index = _set->FindNext(_index + 1);
+                if (_index < _set->End())
+                    _value = DenseIndex<T>::FromIndex(_index);
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                auto temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            bool operator==(const Iterator& rhs) const { return _index == rhs._index; }
+        };
+
+        using value_type = T;
+        using iterator = Iterator;
+        using const_iterator = Iterator;
+
+        DenseSet() = default;
+
+        // Preallocates space for ids up to capacity
+        explicit DenseSet(size_t capacity) { Reserve(capacity); }
+
+        DenseSet(std::initializer_list<T> values) {
+            for (auto& value : values)
+                insert(value);
+        }
+
+        void Reserve(size_t capacity) {
+            auto words = (capacity + 63) / 64;
+            if (words <= _words.size()) return;
+            _words.resize(words);
+            _generations.resize(words);
+        }
+
+        // Returns true if the value was inserted. Ids that can't be stored, such as SegID::None, are rejected.
+        bool insert(T value) {
+            if (!IsStorable(value)) return false;
+            auto index = DenseIndex<T>::ToIndex(value);
+            auto word = index / 64;
+            if (word >= _words.size()) Reserve(std::max(index + 1, _words.size() * 64 * 2));
+
+            if (_generations[word] != _generation) {
+                _generations[word] = _generation;
+                _words[word] = 0;
+            }
+
+            auto mask = 1ULL << (index % 64);
+            if (_words[word] & mask) return false;
+
+            _words[word] |= mask;
+            _endWord = std::max(_endWord, word + 1);
+            _count++;
+            return true;
+        }
+
+        void insert(auto begin, auto end) {
+            for (; begin != end; ++begin)
+                insert(*begin);
+        }
+
+        // Returns the number of elements removed
+        size_t erase(T value) {
+            if (!IsStorable(value)) return 0;
+            auto index = DenseIndex<T>::ToIndex(value);
+            auto word = index / 64;
+            auto mask = 1ULL << (index % 64);
+            if (!(GetWord(word) & mask)) return 0;
+
+            _words[word] &= ~mask;
+            _count--;
+            return 1;
+        }
+
+        bool contains(T value) const {
+            if (!IsStorable(value)) return false;
+            auto index = DenseIndex<T>::ToIndex(value);
+            return GetWord(index / 64) & (1ULL << (index % 64));
+        }
+
+        // Removes all values without releasing memory
+        void clear() {
+            _count = 0;
+            _endWord = 0;
+
+            if (++_generation == 0) {
+                // generation wrapped around, stale words could become valid again
+                ranges::fill(_generations, 0);
+                _generation = 1;
+            }
+        }
+
+        size_t size() const { return _count; }
+        bool empty() const { return _count == 0; }
+
+        Iterator begin() const { return { this, FindNext(0) }; }
+        Iterator end() const { return { this, End() }; }
+
+        bool operator==(const DenseSet& rhs) const {
+            if (_count != rhs._count) return false;
+
+            auto words = std::max(_endWord, rhs._endWord);
+            for (size_t i = 0; i < words; i++) {
+                if (GetWord(i) != rhs.GetWord(i))
+                    return false;
+            }
+
+            return true;
+        }
+    };
+
+    using SegmentSet = DenseSet<SegID>;
+    using SideSet = DenseSet<Tag>;
+    using PointSet = DenseSet<PointID>;
+
+    namespace Seq {
+        template<class T>
+        auto ofSet(const DenseSet<T>& set) {
+            return List<T>(set.begin(), set.end());
+        }
+
+        template<class T>
+        void insert(DenseSet<T>& dest, auto&& src) {
+            dest.insert(src.begin(), src.end());
+        }
+    }
+}
@@ -49,27 +49,143 @@ namespace Inferno {
     }
 
     List<ubyte> HogFile::TryReadEntry(string_view entry) const {
-        for (auto& e : Entries)
-            if (String::InvariantEquals(e.Name, entry)) 
-                return ReadFileToMemory(Path, e.Offset, e.Size);
+        if (auto e = TryFindEntry(entry))
+            return ReadFileToMemory(Path, e->Offset, e->Size);
 
         return {};
     }
 
-    bool HogFile::Exists(string_view entry) const {
-        for (auto& e : Entries)
-            if (String::InvariantEquals(e.Name, entry)) return true;
-
-        return false;
+    const HogEntry* HogFile::TryFindEntry(string_view entry) const {
+        auto it = _lookup.find(String::ToLower(string(entry)));
+        return it != _lookup.end() ? &Entries[it->second] : nullptr;
     }
 
     const HogEntry& HogFile::FindEntry(string_view entry) const {
-        for (auto& e : Entries)
-            if (String::InvariantEquals(e.Name, entry)) return e;
-
+        if (auto e = TryFindEntry(entry)) return *e;
         throw Exception("File not found in hog file");
     }
 
+    void HogFile::UpdateIndex() {
+        _lookup.clear();
+        _extensions.clear();
+        _levels.clear();
+
+        for (int i = 0; i < Entries.size(); i++) {
+            auto name = String::ToLower(Entries[i].Name);
+            _lookup.insert({ name, i }); // keep the first entry when names are duplicated
+
+            if (auto dot = name.rfind('.'); dot != string::npos)
+                _extensions.insert(name.substr(dot + 1));
+
+            if (Entries[i].IsLevel())
+                _levels.push_back(i);
+        }
+    }
+
+    constexpr size_t HOG_ENTRY_HEADER_SIZE = 13 + 4; // name and size
+
+    void HogFile::WriteUpdate(const filesystem::path& dest, span<const HogUpdate> updates) const {
+        Dictionary<string, const HogUpdate*> pending;
+        for (auto& update : updates)
+            pending[String::ToLower(update.Name)] = &update;
+
+        auto findUpdate = [&pending](const string& name) -> const HogUpdate* {
+            auto it = pending.find(String::ToLower(name));
+            return it != pending.end() ? it->second : nullptr;
+        };
+
+        // Find the first entry that can't be overwritten in place
+        size_t firstMoved = Entries.size();
+        size_t entryCount = Entries.size();
+
+        for (size_t i = 0; i < Entries.size(); i++) {
+            if (Entries[i].IsImport())
+                throw Exception("Cannot update a hog with imported entries");
+
+            if (auto update = findUpdate(Entries[i].Name)) {
+                if (update->Data.empty()) entryCount--;
+                if (update->Data.size() != Entries[i].Size)
+                    firstMoved = std::min(firstMoved, i);
+            }
+        }
+
+        for (auto& [name, update] : pending) {
+            if (!_lookup.contains(name) && !update->Data.empty())
+                entryCount++;
+        }
+
+        if (entryCount > MAX_ENTRIES)
+            throw Exception("Cannot have more than 250 entries!");
+
+        // Read the unchanged entries that have to move before truncating
+        Dictionary<size_t, List<ubyte>> moved;
+        for (size_t i = firstMoved; i < Entries.size(); i++) {
+            if (!findUpdate(Entries[i].Name))
+                moved[i] = ReadEntry(Entries[i]);
+        }
+
+        size_t end = 3; // after the signature
+        if (firstMoved < Entries.size())
+            end = Entries[firstMoved].Offset - HOG_ENTRY_HEADER_SIZE;
+        else if (!Entries.empty())
+            end = Entries.back().Offset + Entries.back().Size;
+
+        {
+            std::fstream stream(dest, std::ios::in | std::ios::out | std::ios::binary);
+            if (!stream) throw Exception("Unable to open hog file for update");
+
+            for (size_t i = 0; i < firstMoved; i++) {
+                auto& entry = Entries[i];
+                if (auto update = findUpdate(entry.Name)) {
+                    stream.seekp(entry.Offset);
+                    stream.write((const char*)update->Data.data(), update->Data.size());
+                    pending.erase(String::ToLower(entry.Name));
+                }
+            }
+
+            if (!stream) throw Exception("Error updating hog file");
+        }
+
+        filesystem::resize_file(dest, end);
+
+        std::fstream stream(dest, std::ios::in | std::ios::out | std::ios::binary);
+        if (!stream) throw Exception("Unable to open hog file for update");
+        stream.seekp(end);
+        StreamWriter writer(stream);
+
+        auto writeEntry = [&writer](const string& name, span<const ubyte> data) {
+            if (data.empty()) return;
+            writer.WriteString(name, 13);
+            writer.Write((int32)data.size());
+            writer.WriteBytes(data);
+        };
+
+        // Unchanged entries go first so the updated ones end up at the tail of the file
+        for (size_t i = firstMoved; i < Entries.size(); i++) {
+            if (auto it = moved.find(i); it != moved.end())
+                writeEntry(Entries[i].Name, it->second);
+        }
+
+        for (size_t i = firstMoved; i < Entries.size(); i++) {
+            auto& entry = Entries[i];
+            if (auto update = findUpdate(entry.Name)) {
+                writeEntry(entry.Name, update->Data);
+                pending.erase(String::ToLower(entry.Name));
+            }
+        }
+
+        // Append new entries in the order they were provided
+        for (auto& update : updates) {
+            auto name = String::ToLower(update.Name);
+            if (pending.contains(name)) {
+                writeEntry(update.Name, pending[name]->Data);
+                pending.erase(name);
+            }
+        }
+
+        if (!stream) throw Exception("Error updating hog file");
+    }
+
     HogFile HogFile::Read(filesystem::path file) {
         HogFile hog{};
         hog.Path = file;
@@ -92,6 +208,7 @@ namespace Inferno {
             reader.SeekForward(entry.Size);
         }
 
+        hog.UpdateIndex();
         return hog;
     }
 
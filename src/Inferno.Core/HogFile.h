@@ -41,9 +41,19 @@ namespace Inferno {
         }
     };
 
+    // Replacement data for a hog entry. Empty data removes the entry.
+    struct HogUpdate {
+        string Name;
+        List<ubyte> Data;
+    };
+
     // Contains menu backgrounds, palettes, music, levels
     // A hog file is simply a list of files joined together with name and length headers.
     class HogFile {
+        Dictionary<string, int> _lookup; // Lowercase entry name to index in Entries
+        Set<string> _extensions; // Lowercase extensions of all entries, without the dot
+        List<int> _levels; // Indices of level entries
+
     public:
         List<HogEntry> Entries;
         std::filesystem::path Path;
@@ -59,17 +69,21 @@ namespace Inferno {
         List<ubyte> TryReadEntry(int index) const;
         List<ubyte> TryReadEntry(string_view entry) const;
 
-        bool Exists(string_view entry) const;
+        bool Exists(string_view entry) const { return TryFindEntry(entry); }
         const HogEntry& FindEntry(string_view entry) const;
 
-        bool ContainsFileType(string_view extension) const {
-            for (auto& entry : Entries) {
-                if (entry.Name.ends_with(extension)) return true;
-            }
+        // Case insensitive lookup. Returns null if the entry doesn't exist.
+        const HogEntry* TryFindEntry(string_view entry) const;
 
-            return false;
+        // Extension is case insensitive and can include the dot
+        bool ContainsFileType(string_view extension) const {
+            if (extension.starts_with('.')) extension.remove_prefix(1);
+            return _extensions.contains(String::ToLower(string(extension)));
         }
 
+        // Rebuilds the name lookup. Must be called after modifying Entries.
+        void UpdateIndex();
+
         bool IsDescent1() const { return ContainsFileType("rdl"); }
         bool IsDescent2() const { return ContainsFileType("rl2"); }
 
@@ -90,6 +104,12 @@ namespace Inferno {
         static HogFile Read(std::filesystem::path file);
         static constexpr int MAX_ENTRIES = 250;
 
+        // Applies updates to dest, which must be an unmodified copy of this hog, without rewriting unchanged entries.
+        // Entries that keep their size are overwritten in place. Otherwise the file is truncated at the
+        // first entry that changes size, the unchanged entries after it are written back and the updated and
+        // new entries are appended last. Saving the same entries again then only rewrites the end of the file.
+        void WriteUpdate(const filesystem::path& dest, span<const HogUpdate> updates) const;
+
         List<string> GetContents() {
             return Seq::map(Entries, [](const auto& e) { return e.Name; });
         }
@@ -100,7 +120,7 @@ namespace Inferno {
         }
 
         List<HogEntry> GetLevels() const {
-            return Seq::filter(Entries, [](const HogEntry& e) { return e.IsLevel(); });
+            return Seq::map(_levels, [this](int i) { return Entries[i]; });
         }
     };
 
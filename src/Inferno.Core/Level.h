@@ -8,6 +8,7 @@
 #include "Wall.h"
 #include "DataPool.h"
 #include "Segment.h"
+#include "SegmentGrid.h"
 
 namespace Inferno {
     struct Matcen {
@@ -32,6 +33,12 @@ namespace Inferno {
         SideLighting Color{};
     };
 
+    // Light contributed by a single source from the last bake. Reused when the hash of its inputs matches.
+    struct LightBake {
+        uint64 Hash = 0; // Hash of the geometry, walls, source and settings that affect this light
+        List<Tuple<Tag, SideLighting>> Accumulated;
+    };
+
     // Light generated by a level face
     struct DynamicLightInfo {
         Vector3 Position;
@@ -156,6 +163,12 @@ namespace Inferno {
         Vector3 CameraPosition;
         Vector3 CameraTarget;
         Vector3 CameraUp;
+
+        // Spatial index of segment centers. Invalidated by Segment::UpdateGeometricProps().
+        mutable SegmentGrid Grid;
+
+        // Results of the last light bake keyed by source. Copies share the results instead of duplicating them.
+        Ref<Dictionary<Tag, LightBake>> LightBakes;
 #pragma endregion
 
         bool IsDescent1() const { return Version == 1; }
@@ -439,6 +452,15 @@ namespace Inferno {
             return nullptr;
         }
 
+        // Returns the spatial index of segment centers, rebuilding it if geometry changed.
+        // Not thread safe when a rebuild is necessary.
+        const SegmentGrid& GetSegmentGrid() const {
+            if (!Grid.IsValid() || Grid.Count() != Segments.size())
+                Grid.Rebuild(Segments);
+
+            return Grid;
+        }
+
         void UpdateAllGeometricProps() {
             for (auto& seg : Segments) {
                 seg.UpdateGeometricProps(*this);
@@ -448,6 +470,9 @@ namespace Inferno {
         bool CanAddMatcen() { return Matcens.size() < Limits.Matcens; }
 
         size_t Serialize(StreamWriter& writer);
+
+        // Upper estimate of the serialized size, for reserving a write buffer
+        size_t EstimateSerializedSize() const;
         static Level Deserialize(span<ubyte>);
     };
 }
\ No newline at end of file
@@ -80,9 +80,7 @@ namespace Inferno {
             ReadGameData(level);
             ReadDynamicLights(level);
 
-            for (auto& seg : level.Segments) {
-                seg.UpdateGeometricProps(level);
-            }
+            level.UpdateAllGeometricProps();
 
             return level;
         }
@@ -132,10 +130,14 @@ namespace Inferno {
                         side.OverlayRotation = OverlayRotation(((tmap2 & 0xC000) >> 14) & 3);
                     }
 
+                    // u, v and light for each point
+                    Array<uint16, 12> uvl;
+                    _reader.ReadArray(span(uvl));
+
                     for (int i = 0; i < 4; i++) {
-                        auto u = fix(_reader.ReadInt16()) << 5;
-                        auto v = fix(_reader.ReadInt16()) << 5;
-                        auto l = fix(_reader.ReadUInt16()) << 1;
+                        auto u = fix((int16)uvl[i * 3]) << 5;
+                        auto v = fix((int16)uvl[i * 3 + 1]) << 5;
+                        auto l = fix(uvl[i * 3 + 2]) << 1;
                         side.UVs[i].x = FixToFloat(u);
                         side.UVs[i].y = FixToFloat(v);
                         auto light = FixToFloat(l);
@@ -173,8 +175,7 @@ namespace Inferno {
             level.Vertices.resize(vertexCount);
             level.Segments.resize(segmentCount);
 
-            for (auto& v : level.Vertices)
-                v = _reader.ReadVector();
+            _reader.ReadVectors(level.Vertices);
 
             for (auto& seg : level.Segments) {
                 auto bitMask = _reader.ReadByte();
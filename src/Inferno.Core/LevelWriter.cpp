@@ -601,6 +601,22 @@ namespace Inferno {
         return levelWriter.Write(writer, level);
     }
 
+    size_t Level::EstimateSerializedSize() const {
+        constexpr size_t HeaderSize = 1024; // level info, file info, game data header and reactor triggers
+        constexpr size_t SegmentSize = 256; // connections, vertices, special data, walls and textured sides
+        constexpr size_t ObjectSize = 264; // largest object with AI and physics
+
+        return HeaderSize +
+            Vertices.size() * 12 +
+            Segments.size() * SegmentSize +
+            Objects.size() * ObjectSize +
+            Walls.size() * 24 +
+            Triggers.size() * 52 +
+            Matcens.size() * 20 +
+            LightDeltaIndices.size() * 6 +
+            LightDeltas.size() * 8;
+    }
+
     size_t Level::Serialize(StreamWriter& writer) {
         LevelWriter levelWriter;
         GameVersion = IsDescent1() ? 25 : 32; // Always use the latest version
@@ -27,35 +27,47 @@ namespace Inferno::Outrage {
 
     constexpr int Conv5to8(int n) { return (n << 3) | (n >> 2); }
 
-    List<uint> Decompress(span<ushort> data, int width, int height, ImageType type) {
-        List<uint> img(width * height);
-        const int lastrow = (width - 1) * height;
-
-        for (int ofs = 0; ofs <= lastrow; ofs += width) {
-            if (type == OUTRAGE_4444_COMPRESSED_MIPPED) {
-                for (int x = 0; x < width; x++) {
-                    const ushort n = data[ofs + x];
-                    //const int a = ((n >> 12) & 0x0f) * 0x11;
-                    constexpr int a = 0xff; // ignore alpha for now. it should be extracted as a specular mask
-                    const int r = ((n >> 8) & 0x0f) * 0x11;
-                    const int g = ((n >> 4) & 0x0f) * 0x11;
-                    const int b = (n & 0x0f) * 0x11;
-                    img[ofs + x] = a << 24 | b << 16 | g << 8 | r;
-                }
+    // Expands a 16 bit pixel to RGBA
+    constexpr uint ExpandPixel(ushort n, ImageType type) {
+        if (type == OUTRAGE_4444_COMPRESSED_MIPPED) {
+            //const int a = ((n >> 12) & 0x0f) * 0x11;
+            constexpr uint a = 0xff; // ignore alpha for now. it should be extracted as a specular mask
+            const uint r = ((n >> 8) & 0x0f) * 0x11;
+            const uint g = ((n >> 4) & 0x0f) * 0x11;
+            const uint b = (n & 0x0f) * 0x11;
+            return a << 24 | b << 16 | g << 8 | r;
+        }
+        else {
+            return
+                ((uint)(n & 0x8000) * 0x1fe00) |
+                (Conv5to8((n & 0x7c00) >> 10) << 0) |
+                (Conv5to8((n & 0x03e0) >> 5) << 8) |
+                (Conv5to8((n & 0x001f) >> 0) << 16);
+        }
+    }
+
+    // Decodes the RLE data of a mip. Each run is expanded to RGBA once and then filled.
+    void ReadMip(StreamReader& r, span<uint> dest, ImageType type) {
+        size_t count = 0;
+
+        while (count < dest.size()) {
+            auto cmd = r.ReadByte();
+            auto pixel = ExpandPixel(r.ReadUInt16(), type);
+
+            if (cmd == 0) {
+                dest[count++] = pixel;
+            }
+            else if (cmd >= 2 && cmd <= 250) {
+                if (count + cmd > dest.size())
+                    throw Exception("Compressed run is larger than the image");
+
+                std::fill_n(dest.begin() + count, cmd, pixel);
+                count += cmd;
             }
             else {
-                for (int x = 0; x < width; x++) {
-                    const ushort n = data[ofs + x];
-                    img[ofs + x] =
-                        ((n & 0x8000) * 0x1fe00) |
-                        (Conv5to8((n & 0x7c00) >> 10) << 0) |
-                        (Conv5to8((n & 0x03e0) >> 5) << 8) |
-                        (Conv5to8((n & 0x001f) >> 0) << 16);
-                }
+                throw Exception("Invalid compression command");
             }
         }
-
-        return img;
     }
 
     Bitmap Bitmap::Read(StreamReader& r) {
@@ -100,27 +112,8 @@ namespace Inferno::Outrage {
             auto width = ogf.Width / sz;
             auto height = ogf.Height / sz;
 
-            List<ushort> data(width * height);
-
-            int count = 0;
-
-            while (count < data.size()) {
-                auto cmd = r.ReadByte();
-                ushort pixel = r.ReadUInt16();
-
-                if (cmd == 0) {
-                    data[count++] = pixel;
-                }
-                else if (cmd >= 2 && cmd <= 250) {
-                    for (int i = 0; i < cmd; i++)
-                        data[count++] = pixel;
-                }
-                else {
-                    throw Exception("Invalid compression command");
-                }
-            }
-
-            mip = Decompress(data, width, height, (ImageType)ogf.Type);
+            mip.resize(width * height);
+            ReadMip(r, mip, (ImageType)ogf.Type);
         }
 
         return ogf;
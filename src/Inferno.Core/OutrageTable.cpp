@@ -337,25 +337,50 @@ namespace Inferno::Outrage {
 
     GameTable GameTable::Read(StreamReader& r) {
         GameTable table{};
+        auto length = r.Length();
 
         while (!r.EndOfStream()) {
             auto pageType = r.ReadByte();
             auto pageStart = r.Position();
             auto len = r.ReadInt32();
-            if (len <= 0) throw Exception("bad page length");
+
+            // The length includes itself
+            if (len < (int32)sizeof(int32) || (size_t)len > length - pageStart)
+                throw Exception("bad page length");
 
             switch (pageType) {
                 case PAGETYPE_TEXTURE:
-                    table.Textures.push_back(ReadTexturePage(r));
+                {
+                    auto& tex = table.Textures.emplace_back(ReadTexturePage(r));
+                    auto index = (int)table.Textures.size() - 1;
+                    table._textureNames.try_emplace(String::ToLower(tex.Name), index);
+                    table._textureFileNames.try_emplace(String::ToLower(tex.FileName), index);
                     break;
+                }
 
                 case PAGETYPE_SOUND:
-                    table.Sounds.push_back(ReadSoundPage(r));
+                {
+                    auto page = table.CopyPage(r, len);
+                    StreamReader header(span(table._pageData).subspan(page.Offset, page.Length));
+                    header.ReadInt16(); // version
+                    auto name = header.ReadCString(PAGENAME_LEN);
+
+                    if (table._soundPages.try_emplace(String::ToLower(name), page).second)
+                        table._soundNames.push_back(name);
+
                     break;
+                }
 
                 case PAGETYPE_GENERIC:
-                    table.Generics.push_back(ReadGenericPage(r));
+                {
+                    auto page = table.CopyPage(r, len);
+                    StreamReader header(span(table._pageData).subspan(page.Offset, page.Length));
+                    header.ReadInt16(); // version
+                    header.ReadByte(); // type
+                    auto name = header.ReadCString(PAGENAME_LEN);
+                    table._genericPages.try_emplace(String::ToLower(name), page);
                     break;
+                }
             }
 
             //auto readbytes = r.Position() - pageStart;
@@ -364,4 +389,58 @@ namespace Inferno::Outrage {
 
         return table;
     }
-}
+
+    // Copies the rest of a page into the raw page buffer. len includes the length field.
+    GameTable::PageRef GameTable::CopyPage(StreamReader& r, int32 len) {
+        PageRef page{ _pageData.size(), (size_t)len - sizeof(int32) };
+        _pageData.resize(page.Offset + page.Length);
+        r.ReadBytes(_pageData.data() + page.Offset, page.Length);
+        return page;
+    }
+
+    const TextureInfo* GameTable::FindTexture(const string& name) const {
+        auto it = _textureNames.find(String::ToLower(name));
+        return it != _textureNames.end() ? &Textures[it->second] : nullptr;
+    }
+
+    const TextureInfo* GameTable::FindTextureByFileName(const string& fileName) const {
+        auto it = _textureFileNames.find(String::ToLower(fileName));
+        return it != _textureFileNames.end() ? &Textures[it->second] : nullptr;
+    }
+
+    const SoundInfo* GameTable::FindSound(const string& name) {
+        auto key = String::ToLower(name);
+        if (auto it = _sounds.find(key); it != _sounds.end())
+            return &it->second;
+
+        auto page = _soundPages.find(key);
+        if (page == _soundPages.end()) return nullptr;
+
+        try {
+            StreamReader r(span(_pageData).subspan(page->second.Offset, page->second.Length));
+            auto [it, _] = _sounds.emplace(key, ReadSoundPage(r));
+            return &it->second;
+        }
+        catch (const std::exception&) {
+            return nullptr; // unsupported page version
+        }
+    }
+
+    const GenericInfo* GameTable::FindGeneric(const string& name) {
+        auto key = String::ToLower(name);
+        if (auto it = _generics.find(key); it != _generics.end())
+            return &it->second;
+
+        auto page = _genericPages.find(key);
+        if (page == _genericPages.end()) return nullptr;
+
+        try {
+            StreamReader r(span(_pageData).subspan(page->second.Offset, page->second.Length));
+            auto [it, _] = _generics.emplace(key, ReadGenericPage(r));
+            return &it->second;
+        }
+        catch (const std::exception&) {
+            return nullptr; // unsupported page version
+        }
+    }
+}
\ No newline at end of file
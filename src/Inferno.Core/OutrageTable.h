@@ -376,7 +376,22 @@ namespace Inferno::Outrage {
         constexpr bool HasFlag(GenericFlag flag) { return (bool)(Flags & flag); }
     };
 
-    struct GameTable {
+    // Texture pages are parsed when the table is read. Sound and generic pages are only
+    // indexed by name, then parsed on first use.
+    // Name lookups are case insensitive.
+    class GameTable {
+        Dictionary<string, int> _textureNames, _textureFileNames;
+
+        struct PageRef { size_t Offset, Length; };
+        List<ubyte> _pageData; // Raw sound and generic pages
+        Dictionary<string, PageRef> _soundPages, _genericPages;
+        List<string> _soundNames; // In table order
+        Dictionary<string, SoundInfo> _sounds; // Parsed sound pages
+        Dictionary<string, GenericInfo> _generics; // Parsed generic pages
+
+        PageRef CopyPage(StreamReader& r, int32 len);
+
+    public:
         enum {
             TABLE_FILE_BASE = 0,
             TABLE_FILE_MISSION = 1,
@@ -386,8 +401,17 @@ namespace Inferno::Outrage {
         string Name;
 
         List<TextureInfo> Textures;
-        List<SoundInfo> Sounds;
-        List<GenericInfo> Generics;
+
+        const TextureInfo* FindTexture(const string& name) const;
+        const TextureInfo* FindTextureByFileName(const string& fileName) const;
+
+        // Parse the page on first use. Returns null if the page is missing or has an unsupported version. Not thread safe.
+        const SoundInfo* FindSound(const string& name);
+        const GenericInfo* FindGeneric(const string& name);
+
+        // Names of the sound pages in table order
+        span<const string> SoundNames() const { return _soundNames; }
+
         static GameTable Read(StreamReader&);
     };
 }
\ No newline at end of file
@@ -161,33 +161,115 @@ namespace Inferno {
 
     // Permanently flips image data along Y axis
     void FlipBitmapY(PigBitmap& bmp) {
-        List<ubyte> buffer(bmp.Info.Width * bmp.Info.Height * 4);
         List<ubyte> indexBuffer(bmp.Info.Width * bmp.Info.Height);
-        //const int rowLen = bmp.Info.Width * 4;
         int i = 0;
         for (int row = bmp.Info.Height - 1; row >= 0; row--) {
             auto offset = (uint)row * bmp.Info.Width;
-            memcpy(&buffer[i * 4], &bmp.Data[offset], bmp.Info.Width * 4);
             memcpy(&indexBuffer[i], &bmp.Indexed[offset], bmp.Info.Width);
             i += bmp.Info.Width;
         }
 
-        memcpy(bmp.Data.data(), buffer.data(), buffer.size());
-        memcpy(bmp.Indexed.data(), indexBuffer.data(), indexBuffer.size());
+        bmp.Indexed = std::move(indexBuffer);
     }
 
-    void PigBitmap::ExtractMask() {
+    void PigBitmap::ExpandColors(const Palette& palette, List<Palette::Color>& dest) const {
+        dest.resize(Indexed.size());
+
+        for (size_t i = 0; i < Indexed.size(); i++) {
+            auto palIndex = Indexed[i];
+            dest[i] = palette.Data[palIndex];
+            Palette::CheckTransparency(dest[i], palIndex);
+
+            if (Info.SuperTransparent && palIndex == Palette::ST_INDEX)
+                dest[i] = { 0, 0, 0, 0 }; // the mask covers this pixel
+        }
+    }
+
+    void PigBitmap::ExpandMask(List<Palette::Color>& dest) const {
+        dest.clear();
         if (!Info.SuperTransparent) return;
-        Mask.resize(Data.size());
+        dest.resize(Indexed.size());
+
+        for (size_t i = 0; i < Indexed.size(); i++) {
+            if (Indexed[i] == Palette::ST_INDEX)
+                dest[i] = { 255, 255, 255, 255 };
+            else
+                dest[i] = { 0, 0, 0, 255 };
+        }
+    }
 
-        for (size_t i = 0; i < Data.size(); i++) {
-            if (Data[i].a == Palette::SUPER_ALPHA) {
-                Mask[i] = { 255, 255, 255, 255 };
-                Data[i] = { 0, 0, 0, 0 }; // clear the source pixel
+    Color PigBitmap::GetAverageColor(const Palette& palette) const {
+        int red = 0, green = 0, blue = 0, count = 0;
+
+        for (auto& palIndex : Indexed) {
+            if (palIndex >= Palette::ST_INDEX) continue; // transparent
+            auto& c = palette.Data[palIndex];
+            red += c.r;
+            green += c.g;
+            blue += c.b;
+            count++;
+        }
+
+        if (count == 0) return { 0, 0, 0 };
+        return { (float)red / count / 255.0f, (float)green / count / 255.0f, (float)blue / count / 255.0f, 1 };
+    }
+
+    const List<ubyte>& PaletteLookup::GetCandidates(const Palette::Color& color, bool transparent) {
+        auto& cells = _cells[transparent];
+        if (cells.empty()) cells.resize(GRID_SIZE * GRID_SIZE * GRID_SIZE);
+
+        int r = color.r >> CELL_SHIFT, g = color.g >> CELL_SHIFT, b = color.b >> CELL_SHIFT;
+        auto& candidates = cells[(b * GRID_SIZE + g) * GRID_SIZE + r];
+        if (!candidates.empty()) return candidates;
+
+        constexpr int CELL_WIDTH = 1 << CELL_SHIFT;
+        const Array<int, 3> low = { r * CELL_WIDTH, g * CELL_WIDTH, b * CELL_WIDTH };
+        const Array<int, 3> high = { low[0] + CELL_WIDTH - 1, low[1] + CELL_WIDTH - 1, low[2] + CELL_WIDTH - 1 };
+        auto count = transparent ? 256 : 254;
+
+        // An entry can only be the nearest if its closest distance to the cell is within
+        // the smallest farthest distance of any entry
+        Array<uint, 256> minDist{};
+        uint limit = UINT_MAX;
+
+        for (int i = 0; i < count; i++) {
+            auto& entry = _palette.Data[i];
+            const Array<int, 3> value = { entry.r, entry.g, entry.b };
+            uint nearest = 0, farthest = 0;
+
+            for (int axis = 0; axis < 3; axis++) {
+                int outside = std::max({ low[axis] - value[axis], value[axis] - high[axis], 0 });
+                int extent = std::max(std::abs(value[axis] - low[axis]), std::abs(value[axis] - high[axis]));
+                nearest += outside * outside;
+                farthest += extent * extent;
             }
-            else {
-                Mask[i] = { 0, 0, 0, 255 };
+
+            minDist[i] = nearest;
+            limit = std::min(limit, farthest);
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (minDist[i] <= limit)
+                candidates.push_back((ubyte)i); // ascending order keeps ties on the lowest index
+        }
+
+        return candidates;
+    }
+
+    void PaletteLookup::GetClosestIndices(span<const Palette::Color> colors, span<ubyte> dest, bool transparent) {
+        assert(dest.size() >= colors.size());
+        Palette::Color prev{};
+        ubyte prevIndex = 0;
+
+        for (size_t i = 0; i < colors.size(); i++) {
+            auto& color = colors[i];
+
+            if (i == 0 || color.r != prev.r || color.g != prev.g || color.b != prev.b) {
+                prev = color;
+                prevIndex = GetClosestIndex(color, transparent);
             }
+
+            dest[i] = prevIndex;
         }
     }
 
@@ -211,7 +293,6 @@ namespace Inferno {
 
         List<uint16> rowSize(bmp.Info.Height);
         List<uint8> buffer(bmp.Info.Width * 3);
-        bmp.Data.resize((size_t)bmp.Info.Width * bmp.Info.Height);
         bmp.Indexed.resize((size_t)bmp.Info.Width * bmp.Info.Height);
 
         if (entry.UsesBigRle) {
@@ -233,18 +314,11 @@ namespace Inferno {
                 if (IsRleCode(palIndex)) {
                     auto runLength = std::min(palIndex & ~RLE_CODE, entry.Width - x);
                     palIndex = buffer[offset++];
-                    Palette::Color color = palette.Data[palIndex];
-                    Palette::CheckTransparency(color, palIndex);
-
-                    for (int j = 0; j < runLength; j++, x++, h++) {
-                        bmp.Data[h] = color;
-                        bmp.Indexed[h] = palIndex;
-                    }
+                    memset(&bmp.Indexed[h], palIndex, runLength);
+                    x += runLength, h += runLength;
                 }
                 else {
-                    bmp.Data[h] = palette.Data[palIndex];
                     bmp.Indexed[h] = palIndex;
-                    Palette::CheckTransparency(bmp.Data[h], palIndex);
                     x++, h++;
                 }
             }
@@ -260,18 +334,10 @@ namespace Inferno {
         reader.Seek(dataStart + entry.DataOffset);
 
         PigBitmap bmp(entry);
-        bmp.Data.resize((size_t)entry.Width * entry.Height);
         bmp.Indexed.resize((size_t)entry.Width * entry.Height);
 
-        for (int y = entry.Height - 1; y >= 0; y--) {
-            int h = y * entry.Width;
-            for (int x = 0; x < entry.Width; x++, h++) {
-                auto palIndex = reader.ReadByte();
-                bmp.Indexed[h] = palIndex;
-                bmp.Data[h] = palette.Data[palIndex];
-                Palette::CheckTransparency(bmp.Data[h], palIndex);
-            }
-        }
+        for (int y = entry.Height - 1; y >= 0; y--)
+            reader.ReadBytes(&bmp.Indexed[(size_t)y * entry.Width], entry.Width);
 
         return bmp;
     }
@@ -285,9 +351,6 @@ namespace Inferno {
             ReadBMP(reader, dataStart, palette, entry);
 
         FlipBitmapY(bmp);
-        if (entry.SuperTransparent)
-            bmp.ExtractMask();
-
         return bmp;
     }
 
@@ -305,7 +368,14 @@ namespace Inferno {
     List<PigBitmap> ReadAllBitmaps(const PigFile& pig, const Palette& palette) {
         List<PigBitmap> bitmaps;
 
-        StreamReader reader(pig.Path);
+        // Every entry is read, so load the whole file and parse it from memory
+        std::ifstream file(pig.Path, std::ios::binary);
+        if (!file) throw Exception("Unable to open PIG file");
+        List<ubyte> data(filesystem::file_size(pig.Path));
+        file.read((char*)data.data(), data.size());
+
+        StreamReader reader(std::move(data));
+        bitmaps.reserve(pig.Entries.size());
         for (auto& entry : pig.Entries)
             bitmaps.push_back(ReadBitmapEntry(reader, pig.DataStart, entry, palette));
 
@@ -29,36 +29,41 @@ namespace Inferno {
         Palette() : FadeTables(34 * 256), Data(256) {}
     };
 
-    // Helper that finds the nearest palette index for a color. Uses caching.
+    // Helper that finds the nearest palette index for a color.
+    // Colors are bucketed into a 32x32x32 grid. Each cell stores the palette entries that can be
+    // the nearest to some color inside of it, so a lookup only compares a few candidates.
+    // Cells are filled on first use. Results match a linear search of the palette.
     class PaletteLookup {
+        static constexpr int CELL_SHIFT = 3; // 8 values per channel in each cell
+        static constexpr int GRID_SIZE = 256 >> CELL_SHIFT;
+
         const Palette& _palette;
-        Dictionary<uint32, ubyte> _cache; // maps color to index
+        List<List<ubyte>> _cells[2]; // Candidates for each cell. Indexed by the transparent flag.
+
+        const List<ubyte>& GetCandidates(const Palette::Color& color, bool transparent);
     public:
         PaletteLookup(const Palette& palette) : _palette(palette) {}
 
         ubyte GetClosestIndex(const Palette::Color& color, bool transparent) {
-            uint hash = (int)color.r + ((int)color.g << 8) + ((int)color.b << 16);
-            if (_cache.contains(hash))
-                return _cache[hash];
-
             uint closestDelta = 0x7fffffff;
             ubyte closestIndex = 0;
 
-            for (int i = 0; i < (transparent ? 256 : 254); i++) {
+            for (auto i : GetCandidates(color, transparent)) {
                 uint delta = color.Delta(_palette.Data[i]);
                 if (delta < closestDelta) {
-                    closestIndex = (ubyte)i;
+                    closestIndex = i;
                     if (delta == 0)
                         break;
                     closestDelta = delta;
                 }
             }
 
-            _cache[hash] = closestIndex;
             return closestIndex;
         }
-    };
 
+        // Finds the nearest index for each color. Runs of the same color are only searched once.
+        void GetClosestIndices(span<const Palette::Color> colors, span<ubyte> dest, bool transparent);
+    };
 
     constexpr Color GetAverageColor(span<const Palette::Color> data) {
         int red = 0, green = 0, blue = 0, count = 0;
@@ -154,13 +159,23 @@ namespace Inferno {
         static constexpr uint8 AnimatedFlag = 64;
     };
 
+    // Bitmaps only store palette indices. Colors and the supertransparent mask are
+    // expanded into a caller provided buffer when needed, which keeps a loaded PIG at
+    // a quarter of the size.
     struct PigBitmap {
-        List<Palette::Color> Mask; // Supertransparent mask
-        List<Palette::Color> Data; // Resolved color data
         List<ubyte> Indexed; // Raw index data
 
         PigEntry Info{};
-        void ExtractMask();
+
+        // Resolves the color data using the palette. Supertransparent pixels are cleared
+        // if the bitmap has a mask.
+        void ExpandColors(const Palette& palette, List<Palette::Color>& dest) const;
+
+        // Resolves the supertransparent mask. Leaves dest empty if the bitmap has no mask.
+        void ExpandMask(List<Palette::Color>& dest) const;
+
+        // Average of the opaque pixels
+        Color GetAverageColor(const Palette& palette) const;
 
         PigBitmap() = default;
         PigBitmap(PigEntry entry) : Info(std::move(entry)) {}
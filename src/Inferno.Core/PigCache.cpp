@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "PigCache.h"
+#include "Streams.h"
+#include "Utility.h"
+
+namespace Inferno::PigCache {
+    constexpr uint32 CACHE_SIGNATURE = MakeFourCC("IBMC");
+    constexpr uint32 CACHE_VERSION = 1;
+
+    uint64 GetKey(const filesystem::path& pigPath, span<const ubyte> paletteData) {
+        Fnv1a hash;
+        hash.Append(CACHE_VERSION);
+        hash.AppendBytes(paletteData);
+
+        auto path = pigPath.wstring();
+        hash.AppendBytes({ (const ubyte*)path.data(), path.size() * sizeof(wchar_t) });
+
+        std::error_code ec;
+        hash.Append(filesystem::file_size(pigPath, ec));
+        hash.Append(filesystem::last_write_time(pigPath, ec).time_since_epoch().count());
+        return hash.Value;
+    }
+
+    Option<List<PigBitmap>> Read(const filesystem::path& path, uint64 key, const PigFile& pig) {
+        if (!filesystem::exists(path)) return {};
+
+        try {
+            StreamReader reader(path);
+            if (reader.ReadUInt32() != CACHE_SIGNATURE || reader.ReadUInt32() != CACHE_VERSION)
+                return {};
+
+            if ((uint64)reader.ReadInt64() != key) return {};
+
+            auto count = reader.ReadUInt32();
+            if (count != pig.Entries.size()) return {};
+
+            List<uint32> offsets(count + 1);
+            reader.ReadBytes(offsets.data(), offsets.size() * sizeof(uint32));
+            auto dataStart = reader.Position();
+
+            List<PigBitmap> bitmaps;
+            bitmaps.reserve(count);
+
+            for (uint32 i = 0; i < count; i++) {
+                auto& entry = pig.Entries[i];
+                auto size = (size_t)entry.Width * entry.Height;
+                if (offsets[i + 1] - offsets[i] != size) return {}; // entries don't match the cache
+
+                PigBitmap bmp(entry);
+                bmp.Indexed.resize(size);
+                reader.Seek(dataStart + offsets[i]);
+                reader.ReadBytes(bmp.Indexed.data(), size);
+                bitmaps.push_back(std::move(bmp));
+            }
+
+            return bitmaps;
+        }
+        catch (const std::exception&) {
+            return {}; // treat a corrupt cache as missing
+        }
+    }
+
+    void Write(const filesystem::path& path, uint64 key, span<const PigBitmap> bitmaps) {
+        if (path.has_parent_path())
+            filesystem::create_directories(path.parent_path());
+
+        // Write to a temporary file first so an interrupted write can't leave a corrupt cache
+        auto temp = path;
+        temp += ".tmp";
+
+        {
+            std::ofstream stream(temp, std::ios::binary);
+            if (!stream) throw Exception("Unable to create pig cache");
+
+            StreamWriter writer(stream);
+            writer.Write(CACHE_SIGNATURE);
+            writer.Write(CACHE_VERSION);
+            writer.Write(key);
+            writer.Write((uint32)bitmaps.size());
+
+            uint32 offset = 0;
+            for (auto& bmp : bitmaps) {
+                writer.Write(offset);
+                offset += (uint32)bmp.Indexed.size();
+            }
+
+            writer.Write(offset);
+
+            for (auto& bmp : bitmaps)
+                writer.WriteBytes(bmp.Indexed);
+        }
+
+        filesystem::rename(temp, path);
+    }
+}
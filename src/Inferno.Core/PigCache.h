@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Types.h"
+#include "Pig.h"
+
+namespace Inferno {
+    // Cache of decoded PIG bitmaps stored in a single file. The bitmaps are stored as
+    // palette indices after RLE decoding and flipping so loading is a straight copy.
+    //
+    // Layout: header, a table of offsets for each bitmap, then the index data of every bitmap.
+    namespace PigCache {
+        // Returns a key that changes when the pig file or the palette changes
+        uint64 GetKey(const filesystem::path& pigPath, span<const ubyte> paletteData);
+
+        // Reads the bitmaps for a pig. Returns nothing if the cache is missing, out of date or doesn't match the pig.
+        Option<List<PigBitmap>> Read(const filesystem::path& path, uint64 key, const PigFile& pig);
+
+        void Write(const filesystem::path& path, uint64 key, span<const PigBitmap> bitmaps);
+    }
+}
@@ -79,8 +79,9 @@ namespace Inferno {
                         auto zero = reader.ReadInt16();
                         if (zero != 0) throw Exception("Defpoint Start must equal zero");
 
-                        for (int i = 0; i < n; i++)
-                            points.push_back(reader.ReadVector());
+                        auto start = points.size();
+                        points.resize(start + std::max(n, (int16)0));
+                        reader.ReadVectors(span(points).subspan(start));
 
                         chunkLen = n * 12 /*sizeof(vector)*/ + 8;
                         break;
@@ -66,6 +66,7 @@ namespace Inferno {
             center += *v;
 
         Center = center / (float)verts.size();
+        level.Grid.Invalidate();
     }
 
     float Segment::GetEstimatedVolume(Level& level) {
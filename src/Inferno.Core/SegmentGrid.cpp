@@ -0,0 +1,66 @@
+#include "pch.h"
+#include "SegmentGrid.h"
+
+namespace Inferno {
+    void SegmentGrid::Rebuild(const List<Segment>& segments) {
+        _centers.resize(segments.size());
+        _items.resize(segments.size());
+        _valid = true;
+
+        if (segments.empty()) {
+            _cellStart.clear();
+            return;
+        }
+
+        Vector3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+        Vector3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+        for (size_t i = 0; i < segments.size(); i++) {
+            _centers[i] = segments[i].Center;
+            min = VectorMin(min, _centers[i]);
+            max = VectorMax(max, _centers[i]);
+        }
+
+        // Grow the cells for large levels to keep the table size bounded
+        auto extent = max - min;
+        auto largest = std::max({ extent.x, extent.y, extent.z });
+        _cellSize = std::max(MinCellSize, largest / (MaxCellsPerAxis - 1));
+        _origin = min;
+
+        for (int axis = 0; axis < 3; axis++)
+            _dims[axis] = std::clamp((int)((&extent.x)[axis] / _cellSize) + 1, 1, MaxCellsPerAxis);
+
+        // Count the items in each cell, then convert the counts to offsets
+        _cellStart.assign(_dims[0] * _dims[1] * _dims[2] + 1, 0);
+        List<int> itemCells(segments.size());
+
+        for (size_t i = 0; i < segments.size(); i++) {
+            auto cell = GetCell(_centers[i]);
+            itemCells[i] = CellIndex(cell[0], cell[1], cell[2]);
+            _cellStart[itemCells[i] + 1]++;
+        }
+
+        for (size_t i = 1; i < _cellStart.size(); i++)
+            _cellStart[i] += _cellStart[i - 1];
+
+        List<int> insert(_cellStart.begin(), _cellStart.end() - 1);
+        for (size_t i = 0; i < segments.size(); i++)
+            _items[insert[itemCells[i]]++] = SegID(i);
+    }
+
+    // Spreads the low 10 bits of a value so there are two zero bits between each
+    constexpr uint32 SpreadBits(uint32 x) {
+        x &= 0x3ff;
+        x = (x | (x << 16)) & 0x030000ff;
+        x = (x | (x << 8)) & 0x0300f00f;
+        x = (x | (x << 4)) & 0x030c30c3;
+        x = (x | (x << 2)) & 0x09249249;
+        return x;
+    }
+
+    uint32 SegmentGrid::GetCellKey(const Vector3& point) const {
+        if (_items.empty()) return 0;
+        auto cell = GetCell(point);
+        return SpreadBits(cell[0]) | SpreadBits(cell[1]) << 1 | SpreadBits(cell[2]) << 2;
+    }
+}
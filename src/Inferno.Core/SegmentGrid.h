@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Types.h"
+#include "Utility.h"
+#include "Segment.h"
+
+namespace Inferno {
+    // Uniform grid over segment centers for radius queries.
+    // Items are stored sorted by cell with an offset table, so a query only touches
+    // the cells overlapping the search sphere.
+    class SegmentGrid {
+        List<Vector3> _centers; // Segment centers at the time of the last rebuild
+        List<int> _cellStart; // Offset into _items for each cell. Has one extra entry for the end.
+        List<SegID> _items; // Segment ids sorted by cell
+        Vector3 _origin;
+        float _cellSize = 1;
+        Array<int, 3> _dims{};
+        bool _valid = false;
+
+        static constexpr float MinCellSize = 40;
+        static constexpr int MaxCellsPerAxis = 64;
+
+        Array<int, 3> GetCell(const Vector3& point) const {
+            auto rel = (point - _origin) / _cellSize;
+            return {
+                std::clamp((int)std::floor(rel.x), 0, _dims[0] - 1),
+                std::clamp((int)std::floor(rel.y), 0, _dims[1] - 1),
+                std::clamp((int)std::floor(rel.z), 0, _dims[2] - 1)
+            };
+        }
+
+        int CellIndex(int x, int y, int z) const {
+            return (z * _dims[1] + y) * _dims[0] + x;
+        }
+
+    public:
+        SegmentGrid() = default;
+
+        // Copies start out empty and are rebuilt on demand. This keeps the index out of undo snapshots.
+        SegmentGrid(const SegmentGrid&) {}
+        SegmentGrid& operator=(const SegmentGrid&) {
+            Invalidate();
+            return *this;
+        }
+
+        SegmentGrid(SegmentGrid&&) noexcept = default;
+        SegmentGrid& operator=(SegmentGrid&&) noexcept = default;
+
+        // Marks the grid as needing a rebuild
+        void Invalidate() { _valid = false; }
+        bool IsValid() const { return _valid; }
+
+        // Number of segments in the grid
+        size_t Count() const { return _centers.size(); }
+
+        void Rebuild(const List<Segment>& segments);
+
+        // Calls fn(SegID) for each segment with a center within radius of the point. Order is unspecified.
+        void ForEachInRadius(const Vector3& point, float radius, auto&& fn) const {
+            if (_items.empty()) return;
+
+            auto min = GetCell(point - Vector3(radius));
+            auto max = GetCell(point + Vector3(radius));
+            auto radiusSq = radius * radius;
+
+            for (int z = min[2]; z <= max[2]; z++) {
+                for (int y = min[1]; y <= max[1]; y++) {
+                    auto row = CellIndex(0, y, z);
+
+                    // cells along x are contiguous
+                    for (int i = _cellStart[row + min[0]]; i < _cellStart[row + max[0] + 1]; i++) {
+                        auto id = _items[i];
+                        if (Vector3::DistanceSquared(_centers[(int)id], point) <= radiusSq)
+                            fn(id);
+                    }
+                }
+            }
+        }
+
+        // Returns segments with a center within radius of the point, sorted by id
+        List<SegID> FindInRadius(const Vector3& point, float radius) const {
+            List<SegID> result;
+            ForEachInRadius(point, radius, [&result](SegID id) { result.push_back(id); });
+            Seq::sort(result);
+            return result;
+        }
+
+        // Returns a z-order key for the cell containing the point.
+        // Sorting by this key keeps nearby points close together.
+        uint32 GetCellKey(const Vector3& point) const;
+    };
+}
@@ -39,27 +39,61 @@ namespace Inferno {
     };
 
     // Encapsulates reading binary fixed point data from a stream.
+    // Readers over memory use a cursor into the data instead of a stream, so small reads
+    // are a bounds check and a memcpy instead of a virtual stream call.
     class StreamReader {
         std::unique_ptr<std::istream> _stream;
         std::filesystem::path _file;
         List<ubyte> _data;
+        span<const ubyte> _view; // Data for memory readers
+        size_t _offset = 0; // Cursor for memory readers
+        bool _inMemory = false;
+
+        // Copies bytes from the source. Reading past the end fills the remainder with zeroes, like a failed stream read.
+        void ReadRaw(void* dest, size_t length) {
+            if (!_inMemory) {
+                _stream->read((char*)dest, length);
+                return;
+            }
+
+            auto available = _offset < _view.size() ? std::min(length, _view.size() - _offset) : 0;
+            if (available > 0)
+                memcpy(dest, _view.data() + _offset, available);
+
+            if (available < length) {
+                memset((ubyte*)dest + available, 0, length - available);
+                _offset = _view.size();
+            }
+            else {
+                _offset += length;
+            }
+        }
 
         template<class T>
         T Read() {
             T b{};
-            _stream->read((char*)&b, sizeof(T));
+            if (_inMemory && _offset + sizeof(T) <= _view.size()) {
+                memcpy(&b, _view.data() + _offset, sizeof(T));
+                _offset += sizeof(T);
+            }
+            else {
+                ReadRaw(&b, sizeof(T));
+            }
             return b;
         }
+
     public:
         StreamReader(span<ubyte> data, const string& name = "") {
-            _stream = std::make_unique<MemoryStream>((char*)data.data(), data.size());
+            _view = data;
+            _inMemory = true;
             _file = name;
         }
 
         // Takes ownership of data
         StreamReader(List<ubyte>&& data, const string& name = "") {
             _data = std::move(data);
-            _stream = std::make_unique<MemoryStream>((char*)_data.data(), _data.size());
+            _view = _data;
+            _inMemory = true;
             _file = name;
         }
 
@@ -77,43 +111,52 @@ namespace Inferno {
         StreamReader& operator=(const StreamReader&) = delete;
 
         StreamReader(StreamReader&& other) noexcept {
-            _data = std::move(other._data);
-            _stream = std::move(other._stream);
-            _file.swap(other._file);
+            *this = std::move(other);
         }
 
         StreamReader& operator=(StreamReader&& other) noexcept {
-            _data = std::move(other._data);
+            _data = std::move(other._data); // moving keeps the buffer, so the view stays valid
             _stream = std::move(other._stream);
             _file.swap(other._file);
+            _view = other._view;
+            _offset = other._offset;
+            _inMemory = other._inMemory;
+            return *this;
         }
 
         ~StreamReader() = default;
 
         List<sbyte> ReadSBytes(size_t length) {
             List<sbyte> b(length);
-            _stream->read(b.data(), sizeof(sbyte) * length);
+            ReadRaw(b.data(), sizeof(sbyte) * length);
             return b;
         }
 
         List<ubyte> ReadUBytes(size_t length) {
             List<ubyte> b(length);
-            _stream->read((char*)b.data(), sizeof(ubyte) * length);
+            ReadRaw(b.data(), sizeof(ubyte) * length);
             return b;
         }
 
         void ReadBytes(void* buffer, size_t length) {
-            _stream->read((char*)buffer, length);
+            ReadRaw(buffer, length);
         }
 
         void ReadBytes(span<ubyte> buffer) {
-            _stream->read((char*)buffer.data(), buffer.size());
+            ReadRaw(buffer.data(), buffer.size());
+        }
+
+        // Reads consecutive little endian values into the destination with a single copy
+        template<class T, size_t Extent>
+        void ReadArray(span<T, Extent> dest) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            ReadRaw(dest.data(), dest.size_bytes());
         }
 
         // Reads a fixed length string
         string ReadString(size_t length) {
             List<char> b(length + 1);
-            _stream->read(b.data(), sizeof(char) * length);
+            ReadRaw(b.data(), sizeof(char) * length);
             return { b.data() };
         }
 
@@ -121,7 +164,7 @@ namespace Inferno {
         string ReadCString(size_t maxLen) {
             List<char> b(maxLen + 1);
             for (int i = 0; i < maxLen; i++) {
-                _stream->read(&b[i], sizeof(char));
+                ReadRaw(&b[i], sizeof(char));
                 if (b[i] == '\0') break;
             }
             return { b.data() };
@@ -176,6 +219,15 @@ namespace Inferno {
             return v;
         }
 
+        // Reads consecutive 12 byte fixed point vectors
+        void ReadVectors(span<Vector3> dest) {
+            List<fix> values(dest.size() * 3);
+            ReadArray(span(values));
+
+            for (size_t i = 0; i < dest.size(); i++)
+                dest[i] = { FixToFloat(values[i * 3]), FixToFloat(values[i * 3 + 1]), FixToFloat(values[i * 3 + 2]) };
+        }
+
         // Reads a floating point vector
         Vector3 ReadVector3() {
             Vector3 v;
@@ -214,42 +266,79 @@ namespace Inferno {
         }
 
         bool EndOfStream() { 
+            if (_inMemory) return _offset >= _view.size();
             _stream->peek(); // need to peek to ensure EOF is correct
             return _stream->eof(); 
         }
 
         // Current stream offset
-        size_t Position() { return _stream->tellg(); }
+        size_t Position() { return _inMemory ? _offset : (size_t)_stream->tellg(); }
+
+        // Total size of the stream
+        size_t Length() {
+            if (_inMemory) return _view.size();
+            auto position = _stream->tellg();
+            _stream->seekg(0, std::ios_base::end);
+            auto length = (size_t)_stream->tellg();
+            _stream->seekg(position, std::ios_base::beg);
+            return length;
+        }
 
         // Seek from the beginning
         void Seek(size_t offset) {
-            _stream->seekg(offset, std::ios_base::beg);
+            if (_inMemory)
+                _offset = offset;
+            else
+                _stream->seekg(offset, std::ios_base::beg);
         }
 
         // Seek forward from the current position
         void SeekForward(size_t offset) {
-            _stream->seekg(offset, std::ios_base::cur);
+            if (_inMemory)
+                _offset += offset;
+            else
+                _stream->seekg(offset, std::ios_base::cur);
         }
     };
 
     // Specialized stream writer for Descent binary files
     class StreamWriter {
-        std::ostream& _stream;
+        std::ostream* _stream = nullptr;
         std::streampos _start;
+        List<ubyte>* _buffer = nullptr; // Destination for memory writers
+        size_t _offset = 0; // Cursor for memory writers
+
+        void WriteRaw(const void* data, size_t length) {
+            if (!_buffer) {
+                _stream->write((const char*)data, length);
+                return;
+            }
+
+            if (_offset + length > _buffer->size())
+                _buffer->resize(_offset + length); // grows geometrically
+
+            memcpy(_buffer->data() + _offset, data, length);
+            _offset += length;
+        }
 
     public:
         // Creates a stream writer over an output stream.
         // If relative is true, positions and seeking will be relative to when the writer
         // is created, and not the absolute beginning.
-        StreamWriter(std::ostream& stream, bool relative = false) : _stream(stream) {
+        StreamWriter(std::ostream& stream, bool relative = false) : _stream(&stream) {
             _start = relative ? stream.tellp() : std::streampos(0);
         }
 
+        // Creates a stream writer that appends to a buffer. Writes are a memcpy instead of a stream call,
+        // so prefer this and write the buffer once when serializing many small fields.
+        // Reserve the buffer ahead of time when the size can be estimated.
+        StreamWriter(List<ubyte>& buffer) : _start(0), _buffer(&buffer), _offset(buffer.size()) {}
+
         template<class T>
         void Write(const T value) {
             static_assert(!std::is_floating_point<T>()); // serializing a float is always wrong for Descent files
             static_assert(!std::is_same_v<T, Vector3>); // ambiguous
-            _stream.write((char*)&value, sizeof(T));
+            WriteRaw(&value, sizeof(T));
         }
 
         void WriteFix(float f) {
@@ -280,8 +369,8 @@ namespace Inferno {
             WriteAngle(angles.z);
         }
 
-        void WriteBytes(span<const ubyte> data) const {
-            _stream.write((char*)data.data(), data.size());
+        void WriteBytes(span<const ubyte> data) {
+            WriteRaw(data.data(), data.size());
         }
 
         void WriteNewlineTerminatedString(string s, size_t maxLen) {
@@ -291,7 +380,7 @@ namespace Inferno {
 
             s += '\n';
 
-            _stream.write(s.data(), s.size());
+            WriteRaw(s.data(), s.size());
         }
 
         // Writes a null terminated string
@@ -301,32 +390,33 @@ namespace Inferno {
                 s = s.substr(0, maxLen - 1);
 
             s += '\0';
-            _stream.write(s.data(), s.size());
+            WriteRaw(s.data(), s.size());
         }
 
         // Writes a fixed length string
         void WriteString(string s, size_t length) {
             assert(length > 0);
-
-            for (size_t i = 0; i < length; i++) {
-                if (i < s.length())
-                    _stream.put(s[i]);
-                else
-                    _stream.put('\0');
-            }
+            s.resize(length, '\0'); // truncate or pad with nulls
+            WriteRaw(s.data(), length);
         }
 
         // Current stream position
-        size_t Position() const { return _stream.tellp() - _start; }
+        size_t Position() const { return _buffer ? _offset : (size_t)(_stream->tellp() - _start); }
 
         // Seek from the beginning
         void Seek(std::streampos offset) {
-            _stream.seekp(_start + offset, std::ios_base::beg);
+            if (_buffer)
+                _offset = (size_t)offset;
+            else
+                _stream->seekp(_start + offset, std::ios_base::beg);
         }
 
         // Seek forward from the current position
         void SeekForward(size_t offset) {
-            _stream.seekp(offset, std::ios_base::cur);
+            if (_buffer)
+                _offset += offset;
+            else
+                _stream->seekp(offset, std::ios_base::cur);
         }
     };
 }
\ No newline at end of file
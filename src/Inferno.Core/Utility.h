@@ -110,6 +110,25 @@ namespace Inferno {
         return a >= b ? a * a + a + b : a + b * b;
     }
 
+    // Incremental 64-bit FNV-1a hash. Used to fingerprint data for caches, not for security.
+    struct Fnv1a {
+        uint64 Value = 14695981039346656037ULL;
+
+        void AppendBytes(span<const ubyte> bytes) {
+            for (auto& b : bytes) {
+                Value ^= b;
+                Value *= 1099511628211ULL;
+            }
+        }
+
+        // Appends the raw bytes of a value. Use AppendBytes() for the contents of a buffer.
+        template<class T>
+        void Append(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            AppendBytes({ (const ubyte*)&value, sizeof(T) });
+        }
+    };
+
     // Executes a function on a new thread asynchronously
     void StartAsync(auto&& fun) {
         auto future = std::make_shared<std::future<void>>();
@@ -330,6 +349,32 @@ namespace Inferno {
         });
     }
 
+    // Splits [0, count) into contiguous ranges and calls fn(begin, end) for each range on a separate thread.
+    // Blocks until all ranges finish. Exceptions from workers are rethrown on the calling thread.
+    void ParallelFor(size_t count, auto&& fn, size_t minRangeSize = 64) {
+        auto hardwareThreads = (size_t)std::max(std::thread::hardware_concurrency(), 1u);
+        auto ranges = std::clamp(count / std::max(minRangeSize, size_t(1)), size_t(1), hardwareThreads);
+
+        if (ranges == 1) {
+            fn(size_t(0), count);
+            return;
+        }
+
+        List<std::future<void>> workers;
+        workers.reserve(ranges - 1);
+
+        for (size_t i = 1; i < ranges; i++) {
+            auto begin = count * i / ranges;
+            auto end = count * (i + 1) / ranges;
+            workers.push_back(std::async(std::launch::async, [&fn, begin, end] { fn(begin, end); }));
+        }
+
+        fn(size_t(0), count / ranges); // the calling thread takes the first range
+
+        for (auto& worker : workers)
+            worker.get();
+    }
+
     namespace String {
         constexpr bool Contains(const std::string_view str, const std::string_view value) {
             return str.find(value) != string::npos;
@@ -436,6 +481,50 @@ namespace Inferno {
 
             return hash;
         }
+
+        constexpr std::string_view Base64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        // Encodes binary data as base64 text
+        inline string EncodeBase64(span<const ubyte> data) {
+            string result;
+            result.reserve((data.size() + 2) / 3 * 4);
+
+            for (size_t i = 0; i < data.size(); i += 3) {
+                uint32 chunk = data[i] << 16;
+                if (i + 1 < data.size()) chunk |= data[i + 1] << 8;
+                if (i + 2 < data.size()) chunk |= data[i + 2];
+
+                result += Base64Chars[(chunk >> 18) & 63];
+                result += Base64Chars[(chunk >> 12) & 63];
+                result += i + 1 < data.size() ? Base64Chars[(chunk >> 6) & 63] : '=';
+                result += i + 2 < data.size() ? Base64Chars[chunk & 63] : '=';
+            }
+
+            return result;
+        }
+
+        // Decodes base64 text. Characters outside of the alphabet are skipped.
+        inline List<ubyte> DecodeBase64(std::string_view text) {
+            List<ubyte> result;
+            result.reserve(text.size() / 4 * 3);
+            uint32 chunk = 0;
+            int bits = 0;
+
+            for (auto c : text) {
+                auto value = Base64Chars.find(c);
+                if (value == std::string_view::npos) continue;
+
+                chunk = chunk << 6 | (uint32)value;
+                bits += 6;
+
+                if (bits >= 8) {
+                    bits -= 8;
+                    result.push_back(ubyte(chunk >> bits));
+                }
+            }
+
+            return result;
+        }
     }
 
     // Comparator for invariant equality of strings
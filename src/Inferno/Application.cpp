@@ -4,6 +4,7 @@
 #include "FileSystem.h"
 #include "Input.h"
 #include "Editor/Bindings.h"
+#include "Editor/Editor.Prefetch.h"
 #include "Game.h"
 #include "imgui_local.h"
 #include "BitmapCache.h"
@@ -55,6 +56,7 @@ void LoadAllD3Models() {
 }
 
 void Application::OnShutdown() {
+    Editor::LevelPrefetch::Shutdown();
     Render::Shutdown();
     Sound::Shutdown();
 }
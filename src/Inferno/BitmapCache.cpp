@@ -71,6 +71,16 @@ namespace Inferno {
     }
 
     void TextureGpuCache::LoadTextures(span<RuntimeTextureInfo> textures, bool reload) {
+        // Decode the bitmaps that need loading on worker threads
+        List<string> names;
+        for (auto& tex : textures) {
+            if (tex.VClip < 0 && (tex.BitmapHandle == MaterialHandle::None || reload))
+                names.push_back(tex.FileName);
+        }
+
+        auto bitmaps = Resources::ReadOutrageBitmaps(names);
+        size_t bitmapIndex = 0;
+
         auto batch = BeginUpload();
 
         for (auto& tex : textures) {
@@ -87,7 +97,7 @@ namespace Inferno {
                 }
             }
             else if (tex.BitmapHandle == MaterialHandle::None || reload) {
-                if (auto bmp = Resources::ReadOutrageBitmap(tex.FileName)) {
+                if (auto& bmp = bitmaps[bitmapIndex++]) {
                     Load(batch, tex.BitmapHandle, *bmp);
                 }
             }
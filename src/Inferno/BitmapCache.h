@@ -175,11 +175,8 @@ namespace Inferno {
                     return i; // Already loaded
             }
 
-            for (auto& tex : Resources::GameTable.Textures) {
-                if (String::InvariantEquals(tex.Name, name)) {
-                    return AllocTextureInfo({ tex });
-                }
-            }
+            if (auto tex = Resources::GameTable.FindTexture(name))
+                return AllocTextureInfo({ *tex });
 
             return -1;
         }
@@ -192,10 +189,8 @@ namespace Inferno {
                     return i; // Already exists
             }
 
-            for (auto& tex : Resources::GameTable.Textures) {
-                if (String::InvariantEquals(tex.FileName, fileName))
-                    return AllocTextureInfo({ tex });
-            }
+            if (auto tex = Resources::GameTable.FindTextureByFileName(fileName))
+                return AllocTextureInfo({ *tex });
 
             if (auto id = ResolveVClip(fileName); id != -1)
                 return id;
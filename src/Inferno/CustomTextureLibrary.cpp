@@ -123,11 +123,13 @@ namespace Inferno {
         PigBitmap bmp(entry);
         bmp.Info.Width = (uint16)bmih.biWidth;
         bmp.Info.Height = (uint16)bmih.biHeight;
-        bmp.Data.resize(bmih.biWidth * bmih.biHeight);
         bmp.Indexed.resize(bmih.biWidth * bmih.biHeight);
 
         auto& gamePalette = Resources::GetPalette();
-        PaletteLookup lookup(gamePalette);
+
+        // The source only has 256 colors, so map each of them to the game palette once
+        Array<ubyte, 256> remap{};
+        PaletteLookup(gamePalette).GetClosestIndices(bmpPalette.Data, remap, transparent);
 
         // Index closest to white when using the "white as transparent" option
         PaletteLookup bmpLookup(bmpPalette);
@@ -135,35 +137,32 @@ namespace Inferno {
 
         // read data into bitmap
         int width = ((int)(bmih.biWidth * bmih.biBitCount + 31) >> 3) & ~3;
+        List<ubyte> row(width);
         int z = 0;
         for (int y = 0; y < bmp.Info.Height; y++) {
-            for (int x = 0; x < bmp.Info.Width; x++, z++) {
-                int u = x;
-                int v = !topDown ? bmih.biHeight - y - 1 : y;
+            int v = !topDown ? bmih.biHeight - y - 1 : y;
+            stream.Seek((int)bmfh.bfOffBits + v * width);
+            stream.ReadBytes(row);
+
+            for (int u = 0; u < bmp.Info.Width; u++, z++) {
                 ubyte palIndex{};
 
                 if (bmih.biBitCount == 4) {
-                    long offset = v * width + u / 2;
-                    stream.Seek((int)bmfh.bfOffBits + offset);
-                    palIndex = stream.ReadByte();
+                    palIndex = row[u / 2];
                     if (!(u & 1))
                         palIndex >>= 4;
                     palIndex &= 0x0f;
                 }
                 else {
-                    stream.Seek((int)bmfh.bfOffBits + v * width + u);
-                    palIndex = stream.ReadByte();
+                    palIndex = row[u];
                 }
 
-                auto& c = bmpPalette.Data[palIndex];
-                bmp.Indexed[z] = lookup.GetClosestIndex(c, transparent);
-                bmp.Data[z] = gamePalette.Data[bmp.Indexed[z]];
+                bmp.Indexed[z] = remap[palIndex];
 
-                if (transparent) {
-                    Palette::CheckTransparency(bmp.Data[z], palIndex);
-
-                    if (palIndex >= Palette::ST_INDEX)
-                        bmp.Info.Transparent = true;
+                if (transparent && palIndex >= Palette::ST_INDEX) {
+                    // keep the transparent index of the source so the expanded colors match
+                    bmp.Indexed[z] = palIndex;
+                    bmp.Info.Transparent = true;
 
                     if (palIndex == Palette::ST_INDEX)
                         bmp.Info.SuperTransparent = true;
@@ -171,28 +170,18 @@ namespace Inferno {
 
                 if (whiteAsTransparent && palIndex == whiteIndex) {
                     bmp.Indexed[z] = Palette::T_INDEX;
-                    bmp.Data[z] = { 0, 0, 0, 0 };
                     bmp.Info.Transparent = true;
                 }
             }
         }
 
-        bmp.Info.AverageColor = GetAverageColor(bmp.Data);
+        bmp.Info.AverageColor = bmp.GetAverageColor(gamePalette);
         bmp.Info.Custom = true;
-        bmp.ExtractMask();
 
         SPDLOG_INFO(L"Loaded BMP {}x{} from {}", bmp.Info.Width, bmp.Info.Height, path.wstring());
         _textures[entry.ID] = std::move(bmp);
     }
 
-    void WriteBitmap(StreamWriter& writer, PaletteLookup& lookup, const PigBitmap& bitmap) {
-        for (auto& pixel : bitmap.Data) {
-            // convert color to index and write byte
-            auto index = lookup.GetClosestIndex(pixel, bitmap.Info.Transparent);
-            writer.Write<ubyte>(index);
-        }
-    }
-
     size_t CustomTextureLibrary::WritePog(StreamWriter& writer, const Palette& palette) {
         if (_textures.empty()) return 0;
         auto startPos = writer.Position();
@@ -215,7 +204,6 @@ namespace Inferno {
         }
 
         // write bitmap data
-        PaletteLookup lookup(palette);
         for (auto& id : ids)
             writer.WriteBytes(_textures[id].Indexed);
 
@@ -241,7 +229,6 @@ namespace Inferno {
         // Sound headers would be here but are omitted
 
         // write bitmap data
-        PaletteLookup lookup(palette);
         for (auto& id : ids)
             writer.WriteBytes(_textures[id].Indexed);
 
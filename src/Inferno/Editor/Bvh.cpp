@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "Bvh.h"
+
+namespace Inferno::Editor {
+    void Bvh::Split(int nodeIndex, span<const Bounds> items) {
+        auto node = _nodes[nodeIndex]; // copy, _nodes may reallocate
+        if (node.Count <= MaxLeafSize) return;
+
+        Bounds centers;
+        for (int i = node.First; i < node.First + node.Count; i++)
+            centers.Expand(items[_items[i]].Center());
+
+        // Split along the longest axis of the item centers
+        auto extent = centers.Max - centers.Min;
+        int axis = 0;
+        if (extent.y > extent.x) axis = 1;
+        if (extent.z > (&extent.x)[axis]) axis = 2;
+
+        auto begin = _items.begin() + node.First;
+        auto mid = begin + node.Count / 2;
+        auto end = begin + node.Count;
+
+        std::nth_element(begin, mid, end, [&](int a, int b) {
+            return (&items[a].Min.x)[axis] + (&items[a].Max.x)[axis] <
+                (&items[b].Min.x)[axis] + (&items[b].Max.x)[axis];
+        });
+
+        auto left = (int)_nodes.size();
+        auto leftCount = node.Count / 2;
+
+        Node leftNode, rightNode;
+        leftNode.First = node.First;
+        leftNode.Count = leftCount;
+        rightNode.First = node.First + leftCount;
+        rightNode.Count = node.Count - leftCount;
+
+        for (int i = leftNode.First; i < leftNode.First + leftNode.Count; i++)
+            leftNode.Bounds.Expand(items[_items[i]]);
+
+        for (int i = rightNode.First; i < rightNode.First + rightNode.Count; i++)
+            rightNode.Bounds.Expand(items[_items[i]]);
+
+        _nodes.push_back(leftNode);
+        _nodes.push_back(rightNode);
+
+        auto& parent = _nodes[nodeIndex];
+        parent.Left = left;
+        parent.First = parent.Count = 0;
+
+        Split(left, items);
+        Split(left + 1, items);
+    }
+
+    void Bvh::Build(span<const Bounds> items) {
+        Clear();
+        _itemCount = items.size();
+
+        _items.reserve(items.size());
+        for (int i = 0; i < items.size(); i++) {
+            if (items[i].IsValid())
+                _items.push_back(i);
+        }
+
+        if (_items.empty()) return;
+
+        _nodes.reserve(_items.size() / MaxLeafSize * 2 + 1);
+
+        Node root;
+        root.Count = (int)_items.size();
+        for (auto& i : _items)
+            root.Bounds.Expand(items[i]);
+
+        _nodes.push_back(root);
+        Split(0, items);
+    }
+
+    void Bvh::Refit(span<const Bounds> items) {
+        assert(items.size() == _itemCount);
+
+        // Children are always stored after their parent, so a reverse pass updates leaves first
+        for (int n = (int)_nodes.size() - 1; n >= 0; n--) {
+            auto& node = _nodes[n];
+            node.Bounds = {};
+
+            if (node.Left == -1) {
+                for (int i = node.First; i < node.First + node.Count; i++)
+                    node.Bounds.Expand(items[_items[i]]);
+            }
+            else {
+                node.Bounds.Expand(_nodes[node.Left].Bounds);
+                node.Bounds.Expand(_nodes[node.Left + 1].Bounds);
+            }
+        }
+    }
+}
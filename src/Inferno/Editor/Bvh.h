@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Types.h"
+#include "Utility.h"
+
+namespace Inferno::Editor {
+    // Bounding volume hierarchy over axis aligned boxes. Leaves refer to items by their index
+    // in the span passed to Build(). Refit() updates the bounds after items move without
+    // changing the tree topology, which is much cheaper than a rebuild.
+    class Bvh {
+    public:
+        struct Bounds {
+            Vector3 Min = { FLT_MAX, FLT_MAX, FLT_MAX };
+            Vector3 Max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+            void Expand(const Vector3& p) {
+                Min = VectorMin(Min, p);
+                Max = VectorMax(Max, p);
+            }
+
+            void Expand(const Bounds& b) {
+                Min = VectorMin(Min, b.Min);
+                Max = VectorMax(Max, b.Max);
+            }
+
+            Vector3 Center() const { return (Min + Max) * 0.5f; }
+            bool IsValid() const { return Min.x <= Max.x; }
+
+            DirectX::BoundingBox ToBoundingBox() const {
+                return { Center(), (Max - Min) * 0.5f };
+            }
+        };
+
+    private:
+        struct Node {
+            Bounds Bounds;
+            int Left = -1; // Index of the first child, the second child is Left + 1. -1 for leaves.
+            int First = 0, Count = 0; // Range into _items for leaves
+        };
+
+        List<Node> _nodes;
+        List<int> _items; // Item indices ordered by leaf
+        size_t _itemCount = 0;
+
+        static constexpr int MaxLeafSize = 4;
+
+        void Split(int nodeIndex, span<const Bounds> items);
+
+        // Slab test against the node bounds. Returns true if the ray enters the box before maxDist.
+        static bool RayIntersects(const Bounds& b, const Vector3& origin, const Vector3& invDir, float maxDist) {
+            float tmin = 0, tmax = maxDist;
+
+            for (int axis = 0; axis < 3; axis++) {
+                auto o = (&origin.x)[axis];
+                auto inv = (&invDir.x)[axis];
+                auto t1 = ((&b.Min.x)[axis] - o) * inv;
+                auto t2 = ((&b.Max.x)[axis] - o) * inv;
+                tmin = std::max(tmin, std::min(t1, t2));
+                tmax = std::min(tmax, std::max(t1, t2));
+            }
+
+            return tmin <= tmax;
+        }
+
+        void ForEachItem(const Node& node, auto&& fn) const {
+            if (node.Left == -1) {
+                for (int i = node.First; i < node.First + node.Count; i++)
+                    fn(_items[i]);
+            }
+            else {
+                ForEachItem(_nodes[node.Left], fn);
+                ForEachItem(_nodes[node.Left + 1], fn);
+            }
+        }
+
+    public:
+        // Rebuilds the tree. Invalid bounds are skipped.
+        void Build(span<const Bounds> items);
+
+        // Updates the bounds of all nodes. Items must be the same count as the last build.
+        void Refit(span<const Bounds> items);
+
+        void Clear() {
+            _nodes.clear();
+            _items.clear();
+            _itemCount = 0;
+        }
+
+        // Number of items the tree was built with
+        size_t ItemCount() const { return _itemCount; }
+
+        // Calls fn(item) for each item whose bounds the ray passes through
+        void Raycast(const Ray& ray, float maxDist, auto&& fn) const {
+            if (_nodes.empty()) return;
+
+            auto Inverse = [](float d) {
+                return 1.0f / (std::abs(d) > 1e-8f ? d : std::copysign(1e-8f, d));
+            };
+
+            Vector3 invDir = { Inverse(ray.direction.x), Inverse(ray.direction.y), Inverse(ray.direction.z) };
+
+            Array<int, 64> stack{};
+            int depth = 0;
+            stack[depth++] = 0;
+
+            while (depth > 0) {
+                auto& node = _nodes[stack[--depth]];
+                if (!RayIntersects(node.Bounds, ray.position, invDir, maxDist)) continue;
+
+                if (node.Left == -1) {
+                    for (int i = node.First; i < node.First + node.Count; i++)
+                        fn(_items[i]);
+                }
+                else if (depth + 2 <= stack.size()) {
+                    stack[depth++] = node.Left;
+                    stack[depth++] = node.Left + 1;
+                }
+                else {
+                    ForEachItem(node, fn); // too deep, fall back to testing the whole subtree
+                }
+            }
+        }
+
+        // Calls fn(item) for each item whose bounds touch the frustum
+        void Query(const DirectX::BoundingFrustum& frustum, auto&& fn) const {
+            if (_nodes.empty()) return;
+
+            Array<int, 64> stack{};
+            int depth = 0;
+            stack[depth++] = 0;
+
+            while (depth > 0) {
+                auto& node = _nodes[stack[--depth]];
+                auto containment = frustum.Contains(node.Bounds.ToBoundingBox());
+                if (containment == DirectX::DISJOINT) continue;
+
+                if (containment == DirectX::CONTAINS || node.Left == -1 || depth + 2 > stack.size()) {
+                    ForEachItem(node, fn);
+                }
+                else {
+                    stack[depth++] = node.Left;
+                    stack[depth++] = node.Left + 1;
+                }
+            }
+        }
+    };
+}
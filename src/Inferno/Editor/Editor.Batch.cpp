@@ -0,0 +1,276 @@
+#include "pch.h"
+#include "logging.h"
+#include "Editor.Batch.h"
+#include "Editor.Diagnostics.h"
+#include "Editor.Lighting.h"
+#include "Editor.IO.h"
+#include "LevelSettings.h"
+#include "Resources.h"
+#include "Settings.h"
+#include "Game.h"
+#include "Convert.h"
+
+namespace Inferno::Editor {
+    namespace {
+        struct LevelReport {
+            string Name;
+            string Error;
+            List<SegmentDiagnostic> Diagnostics;
+            string LightingWarning;
+            int64 LightingTime = 0; // milliseconds
+            bool Relit = false;
+        };
+
+        string EscapeJson(string_view str) {
+            string result;
+            result.reserve(str.size());
+
+            for (auto c : str) {
+                switch (c) {
+                    case '"': result += "\\\""; break;
+                    case '\\': result += "\\\\"; break;
+                    case '\n': result += "\\n"; break;
+                    case '\r': result += "\\r"; break;
+                    case '\t': result += "\\t"; break;
+                    default:
+                        if ((unsigned char)c < 0x20)
+                            result += fmt::format("\\u{:04x}", (int)c);
+                        else
+                            result += c;
+                }
+            }
+
+            return result;
+        }
+
+        void WriteReport(std::ostream& stream, const BatchOptions& options, span<const LevelReport> reports, const string& error) {
+            stream << "{\n";
+            stream << fmt::format("  \"mission\": \"{}\",\n", EscapeJson(options.Mission.string()));
+            stream << fmt::format("  \"relight\": {},\n", options.Relight);
+            stream << fmt::format("  \"saved\": {},\n", options.Save && error.empty());
+            stream << fmt::format("  \"error\": \"{}\",\n", EscapeJson(error));
+            stream << "  \"levels\": [";
+
+            for (size_t i = 0; i < reports.size(); i++) {
+                auto& report = reports[i];
+                stream << (i == 0 ? "\n" : ",\n");
+                stream << "    {\n";
+                stream << fmt::format("      \"name\": \"{}\",\n", EscapeJson(report.Name));
+                stream << fmt::format("      \"error\": \"{}\",\n", EscapeJson(report.Error));
+                stream << fmt::format("      \"relit\": {},\n", report.Relit);
+                stream << fmt::format("      \"lightingTime\": {},\n", report.LightingTime);
+                stream << fmt::format("      \"lightingWarning\": \"{}\",\n", EscapeJson(report.LightingWarning));
+                stream << "      \"diagnostics\": [";
+
+                for (size_t j = 0; j < report.Diagnostics.size(); j++) {
+                    auto& diag = report.Diagnostics[j];
+                    stream << (j == 0 ? "\n" : ",\n");
+                    stream << fmt::format("        {{ \"segment\": {}, \"side\": {}, \"message\": \"{}\" }}",
+                                          (int)diag.Tag.Segment, (int)diag.Tag.Side, EscapeJson(diag.Message));
+                }
+
+                stream << (report.Diagnostics.empty() ? "]\n" : "\n      ]\n");
+                stream << "    }";
+            }
+
+            stream << (reports.empty() ? "]\n" : "\n  ]\n");
+            stream << "}\n";
+        }
+
+        // Reads a level and its metadata. The lighting settings saved with the level are written to lighting.
+        Level ReadMissionLevel(const HogFile& mission, const string& name, LightSettings& lighting) {
+            auto data = mission.ReadEntry(name);
+            auto level = Level::Deserialize(data);
+            level.FileName = name;
+
+            auto metadataName = String::NameWithoutExtension(name) + "." + METADATA_EXTENSION;
+            auto metadata = mission.TryReadEntry(metadataName);
+            if (!metadata.empty())
+                LoadLevelMetadata(level, string((char*)metadata.data(), metadata.size()), lighting);
+
+            return level;
+        }
+
+        // Levels with the same key use the same game data and palette
+        string GetResourceKey(const Level& level) {
+            if (level.IsDescent1()) return "d1";
+            return fmt::format("{}:{}", level.IsVertigo() ? "d2x" : "d2", String::ToLower(level.Palette));
+        }
+
+        constexpr auto MISSING_GAME_DATA = "Game data was not found. Check the data paths in the config.";
+    }
+
+    Option<BatchOptions> ParseBatchArgs(int argc, char* argv[]) {
+        Option<BatchOptions> options;
+
+        for (int i = 1; i < argc; i++) {
+            string_view arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--batch" && hasValue) {
+                if (!options) options = BatchOptions{};
+                options->Mission = argv[++i];
+            }
+            else if (arg == "--report" && hasValue) {
+                if (!options) options = BatchOptions{};
+                options->Report = argv[++i];
+            }
+            else if (arg == "--config" && hasValue) {
+                if (!options) options = BatchOptions{};
+                options->Config = argv[++i];
+            }
+            else if (arg == "--relight") {
+                if (!options) options = BatchOptions{};
+                options->Relight = true;
+            }
+            else if (arg == "--save") {
+                if (!options) options = BatchOptions{};
+                options->Save = true;
+            }
+        }
+
+        if (options && options->Mission.empty()) {
+            SPDLOG_ERROR("Batch options require --batch <mission.hog>");
+            return {};
+        }
+
+        if (options && options->Report.empty()) {
+            options->Report = options->Mission;
+            options->Report.replace_extension(".report.json");
+        }
+
+        return options;
+    }
+
+    int RunBatch(const BatchOptions& options) {
+        List<LevelReport> reports;
+        string error;
+        bool hasDiagnostics = false;
+
+        try {
+            if (!options.Config.empty())
+                Settings::Load(options.Config);
+
+            Game::LoadMission(options.Mission);
+            auto& mission = *Game::Mission;
+
+            auto levels = mission.GetLevels();
+            Seq::sortBy(levels, [](HogEntry& a, HogEntry& b) { return a.Name < b.Name; });
+            SPDLOG_INFO("Processing {} levels in {}", levels.size(), options.Mission.string());
+
+            List<Level> loaded(levels.size());
+            reports.resize(levels.size());
+
+            // Settings saved with each level. Levels that get relit are saved with the config settings instead.
+            List<LightSettings> lighting(levels.size(), Settings::Editor.Lighting);
+
+            for (size_t i = 0; i < levels.size(); i++)
+                reports[i].Name = levels[i].Name;
+
+            ParallelFor(levels.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    try {
+                        loaded[i] = ReadMissionLevel(mission, levels[i].Name, lighting[i]);
+                    }
+                    catch (const std::exception& e) {
+                        reports[i].Error = e.what();
+                    }
+                }
+            }, 1);
+
+            // The checks read texture and robot info from the loaded game data, so levels are
+            // validated in parallel in groups that share the same game and palette
+            Dictionary<string, List<size_t>> groups;
+            for (size_t i = 0; i < levels.size(); i++) {
+                if (reports[i].Error.empty())
+                    groups[GetResourceKey(loaded[i])].push_back(i);
+            }
+
+            for (auto& [key, indices] : groups) {
+                Resources::LoadLevel(loaded[indices[0]]);
+
+                if (!Resources::HasGameData()) {
+                    for (auto& i : indices)
+                        reports[i].Error = MISSING_GAME_DATA;
+
+                    continue;
+                }
+
+                ParallelFor(indices.size(), [&](size_t begin, size_t end) {
+                    for (size_t j = begin; j < end; j++) {
+                        auto i = indices[j];
+
+                        try {
+                            auto& report = reports[i];
+                            report.Diagnostics = CheckObjects(loaded[i]);
+                            Seq::append(report.Diagnostics, CheckSegments(loaded[i], false, true));
+                        }
+                        catch (const std::exception& e) {
+                            reports[i].Error = e.what();
+                        }
+                    }
+                }, 1);
+            }
+
+            // Lighting already uses every core for a single level, so levels are lit one at a time.
+            // Each level loads its own game data because the palette and custom textures affect the results.
+            if (options.Relight) {
+                for (size_t i = 0; i < levels.size(); i++) {
+                    auto& report = reports[i];
+                    if (!report.Error.empty()) continue;
+
+                    try {
+                        Resources::LoadLevel(loaded[i]);
+                        if (!Resources::HasGameData())
+                            throw Exception(MISSING_GAME_DATA);
+
+                        SPDLOG_INFO("Lighting {}", report.Name);
+                        auto start = std::chrono::steady_clock::now();
+                        auto warning = LightLevelAndWait(loaded[i], Settings::Editor.Lighting);
+                        lighting[i] = Settings::Editor.Lighting;
+                        report.LightingTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+                        report.LightingWarning = Convert::ToString(warning);
+                        report.Relit = true;
+                    }
+                    catch (const std::exception& e) {
+                        report.Error = e.what();
+                    }
+                }
+            }
+
+            if (options.Save) {
+                // Only save levels that were read successfully
+                List<Level> valid;
+                List<LightSettings> validLighting;
+                for (size_t i = 0; i < levels.size(); i++) {
+                    if (reports[i].Error.empty()) {
+                        valid.push_back(std::move(loaded[i]));
+                        validLighting.push_back(lighting[i]);
+                    }
+                }
+
+                SaveLevelsToHog(valid, validLighting, mission);
+                SPDLOG_INFO("Saved {} levels to {}", valid.size(), options.Mission.string());
+            }
+        }
+        catch (const std::exception& e) {
+            error = e.what();
+            SPDLOG_ERROR("Batch processing failed: {}", error);
+        }
+
+        for (auto& report : reports)
+            hasDiagnostics |= !report.Diagnostics.empty() || !report.Error.empty();
+
+        std::ofstream stream(options.Report);
+        if (!stream) {
+            SPDLOG_ERROR("Unable to write report to {}", options.Report.string());
+            return 1;
+        }
+
+        WriteReport(stream, options, reports, error);
+        SPDLOG_INFO("Wrote report to {}", options.Report.string());
+
+        if (!error.empty()) return 1;
+        return hasDiagnostics ? 2 : 0;
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Types.h"
+
+namespace Inferno::Editor {
+    struct BatchOptions {
+        filesystem::path Mission; // HOG to process
+        filesystem::path Report; // Where to write the JSON report
+        filesystem::path Config; // Settings to use for lighting. Uses the editor settings if empty.
+        bool Relight = false;
+        bool Save = false; // Write the levels back into the mission
+    };
+
+    // Parses the batch options from the command line. Returns nothing if --batch wasn't passed.
+    //
+    // Inferno --batch <mission.hog> [--relight] [--save] [--config <file>] [--report <file>]
+    Option<BatchOptions> ParseBatchArgs(int argc, char* argv[]);
+
+    // Validates, optionally relights and saves every level of a mission without creating a window.
+    // Returns the process exit code: 0 if every level is clean, 2 if any level has diagnostics, 1 on failure.
+    int RunBatch(const BatchOptions&);
+}
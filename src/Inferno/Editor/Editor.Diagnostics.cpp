@@ -377,8 +377,8 @@ namespace Inferno::Editor {
             results.push_back({ 1, {}, message });
         }
 
-        auto boss = Seq::findIndex(Game::Level.Objects, IsBossRobot);
-        auto reactor = Seq::findIndex(Game::Level.Objects, IsReactor);
+        auto boss = Seq::findIndex(level.Objects, IsBossRobot);
+        auto reactor = Seq::findIndex(level.Objects, IsReactor);
 
         if ((boss || reactor) && !HasExitConnection(level)) {
             auto message =
@@ -400,99 +400,189 @@ namespace Inferno::Editor {
         return ti1.Width == ti2.Width && ti1.Height == ti2.Height;
     }
 
-    List<SegmentDiagnostic> CheckSegments(Level& level, bool fixErrors, bool checkDegeneracy) {
-        List<SegmentDiagnostic> results;
-        bool changedLevel = false;
+    // Checks a single segment. The level is only modified when fixErrors is true.
+    // Returns true if a connection error was found, which is always fixed when fixErrors is true.
+    bool CheckSegment(Level& level, SegID segid, bool fixErrors, bool checkDegeneracy, List<SegmentDiagnostic>& results) {
+        auto& seg = level.GetSegment(segid);
+        bool connectionError = false;
 
-        for (int i = 0; i < level.Segments.size(); i++) {
-            auto& seg = level.Segments[i];
-            auto segid = SegID(i);
-
-            if (seg.Type == SegmentType::Matcen) {
-                // this doesn't check links, but matcens need to be sorted for that
-                if (!level.TryGetMatcen(seg.Matcen)) {
-                    results.push_back({ 0, { segid, SideID::None }, "Matcen data is missing" });
-                }
+        if (seg.Type == SegmentType::Matcen) {
+            // this doesn't check links, but matcens need to be sorted for that
+            if (!level.TryGetMatcen(seg.Matcen)) {
+                results.push_back({ 0, { segid, SideID::None }, "Matcen data is missing" });
             }
+        }
 
-            if (checkDegeneracy) {
-                if (CheckDegeneracy(level, seg) > MAX_DEGENERACY) {
-                    results.push_back({ 0, { segid, SideID::None }, "Degenerate geometry" });
-                }
-                else if (auto flatness = CheckSegmentFlatness(level, seg); flatness <= 0.80f) {
-                    results.push_back({ 0, { segid, SideID::None }, fmt::format("Bad geometry flatness {:.2f}", flatness) });
-                }
+        if (checkDegeneracy) {
+            if (CheckDegeneracy(level, seg) > MAX_DEGENERACY) {
+                results.push_back({ 0, { segid, SideID::None }, "Degenerate geometry" });
+            }
+            else if (auto flatness = CheckSegmentFlatness(level, seg); flatness <= 0.80f) {
+                results.push_back({ 0, { segid, SideID::None }, fmt::format("Bad geometry flatness {:.2f}", flatness) });
             }
+        }
+
+        Set<PointID> indices;
+        Seq::insert(indices, seg.Indices);
+        if (indices.size() < 8) {
+            results.push_back({ 0, { segid, SideID::None }, "Segment has merged points and will cause crashes" });
+        }
 
-            Set<PointID> indices;
-            Seq::insert(indices, seg.Indices);
-            if (indices.size() < 8) {
-                results.push_back({ 0, { segid, SideID::None }, "Segment has merged points and will cause crashes" });
+        for (auto& side : SideIDs) {
+            if (!CheckOverlayTextureSize(seg.GetSide(side))) {
+                results.push_back({ 0, { segid, side }, "Overlay and base texture size are different. This will crash most ports." });
             }
 
-            for (auto& side : SideIDs) {
-                if (!CheckOverlayTextureSize(seg.GetSide(side))) {
-                    results.push_back({ 0, { segid, side }, "Overlay and base texture size are different. This will crash most ports." });
-                }
+            auto connId = seg.GetConnection(side);
+            if (connId == SegID::Exit || connId == SegID::None) continue;
 
-                auto connId = seg.GetConnection(side);
-                if (connId == SegID::Exit || connId == SegID::None) continue;
+            auto conn = level.TryGetSegment(connId);
 
-                auto conn = level.TryGetSegment(connId);
+            if (!conn) {
+                connectionError = true;
 
-                if (!conn) {
-                    if (fixErrors) {
-                        auto msg = fmt::format("Removed bad segment connection to {}", connId);
-                        results.push_back({ 2, { segid, side }, msg });
-                        seg.Connections[(int)side] = SegID::None;
-                        changedLevel = true;
-                    }
-                    else {
-                        auto msg = fmt::format("Bad segment connection to {}", connId);
-                        results.push_back({ 0, { segid, side }, msg });
-                    }
+                if (fixErrors) {
+                    auto msg = fmt::format("Removed bad segment connection to {}", connId);
+                    results.push_back({ 2, { segid, side }, msg });
+                    seg.Connections[(int)side] = SegID::None;
                 }
+                else {
+                    auto msg = fmt::format("Bad segment connection to {}", connId);
+                    results.push_back({ 0, { segid, side }, msg });
+                }
+            }
+
+            if (auto other = level.GetConnectedSide({ segid, side })) {
+                // Check that vertices match between connections
+                if (!SidesMatch(level, { segid, side }, other)) {
+                    connectionError = true;
 
-                if (auto other = level.GetConnectedSide({ segid, side })) {
-                    // Check that vertices match between connections
-                    if (!SidesMatch(level, { segid, side }, other)) {
-                        // Try to weld the vertex to fix the mismatch
-                        if (fixErrors && WeldConnection(level, { segid, side }, 0.01f)) {
-                            results.push_back({ 2, { segid, side }, fmt::format("Fixed connection to {}", connId) });
-                            changedLevel = true;
+                    // Try to weld the vertex to fix the mismatch
+                    if (fixErrors && WeldConnection(level, { segid, side }, 0.01f)) {
+                        results.push_back({ 2, { segid, side }, fmt::format("Fixed connection to {}", connId) });
+                    }
+                    else {
+                        if (fixErrors) {
+                            seg.Connections[(int)side] = SegID::None;
+                            conn->GetConnection(other.Side) = SegID::None;
+                            auto msg = fmt::format("Removed mismatched connection to {}", connId);
+                            results.push_back({ 2, { segid, side }, msg });
                         }
                         else {
-                            if (fixErrors) {
-                                seg.Connections[(int)side] = SegID::None;
-                                conn->GetConnection(other.Side) = SegID::None;
-                                auto msg = fmt::format("Removed mismatched connection to {}", connId);
-                                results.push_back({ 2, { segid, side }, msg });
-                                changedLevel = true;
-                            }
-                            else {
-                                auto msg = fmt::format("Mismatched connection to {}", connId);
-                                results.push_back({ 1, { segid, side }, msg });
-                            }
+                            auto msg = fmt::format("Mismatched connection to {}", connId);
+                            results.push_back({ 1, { segid, side }, msg });
                         }
                     }
                 }
+            }
+            else {
+                connectionError = true;
+
+                if (fixErrors) {
+                    auto msg = fmt::format("Removed bad connection to {}", connId);
+                    results.push_back({ 2, { segid, side }, msg });
+                    seg.Connections[(int)side] = SegID::None;
+                }
                 else {
-                    if (fixErrors) {
-                        auto msg = fmt::format("Removed bad connection to {}", connId);
-                        results.push_back({ 2, { segid, side }, msg });
-                        seg.Connections[(int)side] = SegID::None;
-                        changedLevel = true;
-                    }
-                    else {
-                        auto msg = fmt::format("Bad connection to {}", connId);
-                        results.push_back({ 0, { segid, side }, msg });
-                    }
+                    auto msg = fmt::format("Bad connection to {}", connId);
+                    results.push_back({ 0, { segid, side }, msg });
                 }
             }
         }
 
-        if (changedLevel)
+        return connectionError;
+    }
+
+    // Fingerprints the segment data used by the checks
+    uint64 HashSegment(const Level& level, const Segment& seg) {
+        Fnv1a hash;
+
+        hash.Append(seg.Connections);
+        hash.Append(seg.Indices);
+        hash.Append(seg.Type);
+        hash.Append(seg.Matcen);
+        hash.Append(level.TryGetMatcen(seg.Matcen) != nullptr);
+
+        for (auto& side : seg.Sides) {
+            hash.Append(side.Type);
+            hash.Append(side.TMap);
+            hash.Append(side.TMap2);
+        }
+
+        for (auto& index : seg.Indices) {
+            if (index < level.Vertices.size())
+                hash.Append(level.Vertices[index]);
+        }
+
+        return hash.Value;
+    }
+
+    List<SegmentDiagnostic> CheckSegments(Level& level, bool fixErrors, bool checkDegeneracy, SegmentDiagnosticCache* cache) {
+        SegmentDiagnosticCache localCache;
+        if (!cache) cache = &localCache;
+
+        if (cache->CheckDegeneracy != checkDegeneracy) {
+            cache->Clear();
+            cache->CheckDegeneracy = checkDegeneracy;
+        }
+
+        auto segCount = level.Segments.size();
+        List<uint64> hashes(segCount);
+        List<uint8> modified(segCount); // not List<bool>, threads write to adjacent elements
+
+        ParallelFor(segCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                hashes[i] = HashSegment(level, level.Segments[i]);
+                modified[i] = i >= cache->Hashes.size() || cache->Hashes[i] != hashes[i];
+            }
+        });
+
+        // Connection checks depend on the neighbors, so also recheck segments next to modified ones
+        List<SegID> dirty;
+        for (int i = 0; i < segCount; i++) {
+            bool recheck = modified[i];
+
+            for (auto& conn : level.Segments[i].Connections) {
+                if (recheck) break;
+                if ((int)conn >= 0 && (int)conn < segCount && modified[(int)conn])
+                    recheck = true;
+            }
+
+            if (recheck) dirty.push_back(SegID(i));
+        }
+
+        cache->Hashes = std::move(hashes);
+        cache->Results.resize(segCount);
+        List<uint8> connectionErrors(dirty.size());
+
+        ParallelFor(dirty.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                auto& results = cache->Results[(int)dirty[i]];
+                results.clear();
+                connectionErrors[i] = CheckSegment(level, dirty[i], false, checkDegeneracy, results);
+            }
+        });
+
+        // Fixes modify neighboring segments, so apply them serially in segment order
+        bool changedLevel = false;
+
+        if (fixErrors) {
+            for (size_t i = 0; i < dirty.size(); i++) {
+                if (!connectionErrors[i]) continue;
+                auto& results = cache->Results[(int)dirty[i]];
+                results.clear();
+                changedLevel |= CheckSegment(level, dirty[i], true, checkDegeneracy, results);
+            }
+        }
+
+        List<SegmentDiagnostic> results;
+        for (auto& segResults : cache->Results)
+            Seq::append(results, segResults);
+
+        if (changedLevel) {
+            cache->Clear(); // fixes can affect segments that were already checked
             Editor::History.SnapshotLevel("Fix segments");
+        }
 
         return results;
     }
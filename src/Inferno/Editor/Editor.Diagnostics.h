@@ -24,6 +24,21 @@ namespace Inferno::Editor {
 
     float CheckDegeneracy(const Level& level, const Segment& seg);
 
+    // Results of the previous segment check, used to only recheck segments that changed
+    struct SegmentDiagnosticCache {
+        List<uint64> Hashes; // Fingerprint of each segment when it was last checked
+        List<List<SegmentDiagnostic>> Results; // Diagnostics for each segment
+        bool CheckDegeneracy = false;
+
+        void Clear() {
+            Hashes.clear();
+            Results.clear();
+        }
+    };
+
     List<SegmentDiagnostic> CheckObjects(const Level& level);
-    List<SegmentDiagnostic> CheckSegments(Level& level, bool fixErrors, bool checkDegeneracy);
+
+    // Checks all segments for errors. The read-only checks run in parallel.
+    // If a cache is provided, only segments that changed since the last check are rechecked.
+    List<SegmentDiagnostic> CheckSegments(Level& level, bool fixErrors, bool checkDegeneracy, SegmentDiagnosticCache* cache = nullptr);
 }
\ No newline at end of file
@@ -136,27 +136,32 @@ namespace Inferno::Editor {
         auto src = level.TryGetSegment(srcId);
         if (!src) return nearbySegs;
 
-        for (SegID id = {}; (int)id < level.Segments.size(); id++) {
-            auto& seg = level.GetSegment(id);
-            if (id == srcId) continue;
-            auto dist = Vector3::Distance(src->Center, seg.Center);
-            if (dist <= distance) nearbySegs.push_back(id);
-        }
-
+        nearbySegs = level.GetSegmentGrid().FindInRadius(src->Center, distance);
+        Seq::remove(nearbySegs, srcId);
         return nearbySegs;
     }
 
     // Gets nearby segments excluding the ones in ids
     List<SegID> GetNearbySegmentsExclusive(Level& level, span<SegID> ids, float distance) {
-        Set<SegID> nearby;
+        auto& grid = level.GetSegmentGrid();
+        List<bool> found(level.Segments.size());
 
-        for (auto& id : ids)
-            Seq::insert(nearby, GetNearbySegments(level, id, distance));
+        for (auto& id : ids) {
+            if (auto seg = level.TryGetSegment(id))
+                grid.ForEachInRadius(seg->Center, distance, [&found](SegID nearby) { found[(int)nearby] = true; });
+        }
 
-        for (auto& id : ids)
-            nearby.erase(id);
+        for (auto& id : ids) {
+            if (level.SegmentExists(id))
+                found[(int)id] = false;
+        }
+
+        List<SegID> nearby;
+        for (int i = 0; i < found.size(); i++) {
+            if (found[i]) nearby.push_back(SegID(i));
+        }
 
-        return Seq::ofSet(nearby);
+        return nearby;
     }
 
     void DeleteVertex(Level& level, uint16 index) {
@@ -241,24 +246,31 @@ namespace Inferno::Editor {
 
     // Deletes unused vertices. Returns true if any were deleted.
     bool PruneVertices(Level& level) {
-        List<PointID> unused;
+        List<bool> used(level.Vertices.size());
 
-        auto LevelUsesVertex = [&](int v) {
-            for (auto& seg : level.Segments)
-                for (auto& i : seg.Indices)
-                    if (i == v) return true;
-            return false;
-        };
+        for (auto& seg : level.Segments)
+            for (auto& i : seg.Indices)
+                if (i < used.size()) used[i] = true;
 
-        for (PointID v = 0; v < level.Vertices.size(); v++) {
-            if (!LevelUsesVertex(v)) unused.push_back(v);
+        // Old vertex index -> new vertex index
+        List<PointID> remap(level.Vertices.size());
+        PointID next = 0;
+
+        for (size_t v = 0; v < level.Vertices.size(); v++) {
+            if (!used[v]) continue;
+            remap[v] = next;
+            level.Vertices[next++] = level.Vertices[v];
         }
 
-        Seq::sortDescending(unused);
-        for (auto& v : unused)
-            DeleteVertex(level, v);
+        if (next == level.Vertices.size())
+            return false;
+
+        for (auto& seg : level.Segments)
+            for (auto& i : seg.Indices)
+                if (i < remap.size()) i = remap[i];
 
-        return !unused.empty();
+        level.Vertices.resize(next);
+        return true;
     }
 
     // Merges overlapping verts
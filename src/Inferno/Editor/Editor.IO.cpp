@@ -10,10 +10,9 @@
 #include "Editor.h"
 #include "Graphics/Render.h"
 #include "Editor.Diagnostics.h"
+#include "Editor.Prefetch.h"
 
 namespace Inferno::Editor {
-    constexpr auto METADATA_EXTENSION = "ied"; // inferno engine data
-
     size_t SaveLevel(Level& level, StreamWriter& writer) {
         if (level.Walls.size() >= (int)WallID::Max)
             throw Exception("Cannot save a level with more than 255 walls");
@@ -31,6 +30,16 @@ namespace Inferno::Editor {
         return level.Serialize(writer);
     }
 
+    // Serializes data to a vector using the provided function
+    std::vector<ubyte> SerializeToMemory(std::function<size_t(StreamWriter&)> fn, size_t capacity = 0) {
+        std::vector<ubyte> data;
+        data.reserve(capacity);
+        StreamWriter writer(data);
+        auto len = fn(writer);
+        data.resize(len);
+        return data;
+    }
+
     // Saves a level to the file system
     void SaveLevelToPath(Level& level, std::filesystem::path path, bool autosave = false) {
         CleanLevel(level);
@@ -39,10 +48,14 @@ namespace Inferno::Editor {
         temp.replace_extension("tmp");
 
         {
-            // Write to temp file
-            std::ofstream file(temp, std::ios::binary);
-            StreamWriter writer(file, false);
+            // Serialize to memory and write the temp file at once
+            List<ubyte> buffer;
+            buffer.reserve(Game::Level.EstimateSerializedSize());
+            StreamWriter writer(buffer);
             SaveLevel(Game::Level, writer);
+
+            std::ofstream file(temp, std::ios::binary);
+            file.write((char*)buffer.data(), buffer.size());
         }
 
         if (filesystem::exists(path)) {
@@ -62,7 +75,7 @@ namespace Inferno::Editor {
         level.CameraPosition = Render::Camera.Position;
         level.CameraTarget = Render::Camera.Target;
         level.CameraUp = Render::Camera.Up;
-        SaveLevelMetadata(level, metadata);
+        SaveLevelMetadata(level, metadata, Settings::Editor.Lighting);
         SetStatusMessage(L"Saved level to {}", path.wstring());
 
         // Save custom textures
@@ -70,15 +83,15 @@ namespace Inferno::Editor {
             auto ext = level.IsDescent1() ? ".dtx" : ".pog";
             filesystem::path texPath = path;
             texPath.replace_extension(ext);
-            std::ofstream file(texPath, std::ios::binary);
-            StreamWriter writer(file, false);
 
-            if (level.IsDescent1()) {
-                Resources::CustomTextures.WriteDtx(writer, Resources::GetPalette());
-            }
-            else {
-                Resources::CustomTextures.WritePog(writer, Resources::GetPalette());
-            }
+            auto data = SerializeToMemory([&level](StreamWriter& writer) {
+                if (level.IsDescent1())
+                    return Resources::CustomTextures.WriteDtx(writer, Resources::GetPalette());
+                else
+                    return Resources::CustomTextures.WritePog(writer, Resources::GetPalette());
+            });
+
+            File::WriteAllBytes(texPath, data);
         }
 
         if (!autosave) {
@@ -112,9 +125,10 @@ namespace Inferno::Editor {
         if (metadataStream) {
             std::stringstream metadata;
             metadata << metadataStream.rdbuf();
-            LoadLevelMetadata(level, metadata.str());
+            LoadLevelMetadata(level, metadata.str(), Settings::Editor.Lighting);
         }
 
+        LevelPrefetch::Clear();
         Game::UnloadMission();
         Game::LoadLevel(std::move(level));
         SetStatusMessage("Loaded level {}", path.filename().string());
@@ -135,117 +149,158 @@ namespace Inferno::Editor {
         return -1;
     }
 
-    void AppendVertigoData(HogWriter& writer, string hamName) {
+    // Returns the d2x.ham data for Vertigo levels, or nothing if it is unavailable
+    List<ubyte> ReadVertigoData() {
         try {
-            //if (mission.ContainsFileType(".ham")) return; // Already has ham data
             if (!Resources::FoundVertigo()) {
                 SPDLOG_WARN("Level is marked as Vertigo but has no .ham and d2x.hog was not found");
-                return;
+                return {};
             }
 
-            // Insert vertigo data
             auto d2xhog = HogFile::Read(FileSystem::FindFile(L"d2x.hog"));
-            auto vertigoData = d2xhog.ReadEntry("d2x.ham");
-            writer.WriteEntry(hamName, vertigoData);
-            SPDLOG_INFO("Copied Vertigo d2x.ham into HOG");
+            return d2xhog.ReadEntry("d2x.ham");
         }
         catch (const std::exception& e) {
             SPDLOG_ERROR("Unable to add vertigo data: {}", e.what());
+            return {};
         }
     }
 
-    // Serializes data to a vector using the provided function
-    std::vector<ubyte> SerializeToMemory(std::function<size_t(StreamWriter&)> fn) {
-        std::stringstream stream;
-        stream.unsetf(std::ios::skipws);
-        StreamWriter writer(stream);
-        auto len = fn(writer);
-        std::vector<ubyte> data(len);
-        stream.read((char*)data.data(), data.size());
-        return data;
-    }
-
     // Serializes level settings to bytes
-    std::vector<ubyte> SerializeLevelMetadata(const Level& level) {
+    std::vector<ubyte> SerializeLevelMetadata(const Level& level, const LightSettings& lighting) {
         std::stringstream stream;
         stream.unsetf(std::ios::skipws);
-        SaveLevelMetadata(level, stream);
+        SaveLevelMetadata(level, stream, lighting);
         std::vector<ubyte> data(stream.tellp());
         stream.read((char*)data.data(), data.size());
         return data;
     }
 
-    // Writes a HOG file and updates the level
-    void WriteHog(Level& level, HogFile& mission, filesystem::path path) {
-        filesystem::path tempPath = path;
-        tempPath.replace_extension(".tmp");
+    // Replaces a file with the temp file. The existing file is moved to the backup instead of copied.
+    void ReplaceFromTemp(const filesystem::path& path, const filesystem::path& tempPath) {
+        if (filesystem::exists(path)) {
+            filesystem::path backupPath = path;
+            backupPath.replace_extension(".bak");
+            filesystem::rename(path, backupPath);
+        }
 
-        try {
-            if (level.FileName.empty())
-                throw Exception("Level filename is empty!");
+        filesystem::rename(tempPath, path);
+    }
 
-            auto baseName = String::NameWithoutExtension(level.FileName);
-            auto metadataName = baseName + "." + METADATA_EXTENSION;
-            HogWriter writer(tempPath); // write to temp
-            fmt::print("Copying existing HOG files:\n");
-
-            for (auto& entry : mission.Entries) {
-                // Does the file match the level name?
-                if (entry.NameWithoutExtension() == baseName) {
-                    // Skip files serialized later
-                    constexpr std::array skippedExtensions = { ".dtx", ".pog", ".rl2", ".rdl", ".ied" };
-                    auto ext = String::ToLower(entry.Extension());
-                    if (Seq::contains(skippedExtensions, ext))
-                        continue;
-                }
+    // Serializes the level and its related files for saving into a HOG
+    List<HogUpdate> GetLevelHogEntries(Level& level, const HogFile& mission, const filesystem::path& path) {
+        if (level.FileName.empty())
+            throw Exception("Level filename is empty!");
+
+        auto baseName = String::NameWithoutExtension(level.FileName);
+        List<HogUpdate> entries;
+
+        // Remove existing files that are serialized with the level
+        for (auto& entry : mission.Entries) {
+            if (entry.NameWithoutExtension() == baseName) {
+                constexpr std::array serializedExtensions = { ".dtx", ".pog", ".rl2", ".rdl", ".ied" };
+                auto ext = String::ToLower(entry.Extension());
+                if (Seq::contains(serializedExtensions, ext))
+                    entries.push_back({ entry.Name });
+            }
+        }
 
-                auto data = mission.ReadEntry(entry);
-                writer.WriteEntry(entry.Name, data);
-                fmt::print("{}:{}\n", entry.Name, data.size());
+        // Level and metadata
+        entries.push_back({ level.FileName, SerializeToMemory([&level](StreamWriter& w) { return SaveLevel(level, w); }, level.EstimateSerializedSize()) });
+        entries.push_back({ baseName + "." + METADATA_EXTENSION, SerializeLevelMetadata(level, Settings::Editor.Lighting) }); // IED file
+
+        if (level.IsVertigo() && !mission.ContainsFileType(".ham")) {
+            if (auto ham = ReadVertigoData(); !ham.empty()) {
+                entries.push_back({ path.stem().string() + ".ham", std::move(ham) });
+                SPDLOG_INFO("Copied Vertigo d2x.ham into HOG");
+            }
+        }
+
+        if (Resources::CustomTextures.Any()) {
+            if (mission.IsDescent1()) {
+                entries.push_back({ baseName + ".dtx", SerializeToMemory([](StreamWriter& w) {
+                    return Resources::CustomTextures.WriteDtx(w, Resources::GetPalette());
+                }) });
             }
+            else {
+                entries.push_back({ baseName + ".pog", SerializeToMemory([](StreamWriter& w) {
+                    return Resources::CustomTextures.WritePog(w, Resources::GetPalette());
+                }) });
+            }
+        }
 
+        return entries;
+    }
 
-            fmt::print("\nWriting new files: ");
+    // Writes a HOG file and updates the level.
+    // Saving over the loaded mission only rewrites the entries that changed.
+    void WriteHog(Level& level, HogFile& mission, filesystem::path path) {
+        filesystem::path tempPath = path;
+        tempPath.replace_extension(".tmp");
 
-            // Write level and metadata
-            auto levelData = SerializeToMemory([&level](StreamWriter& w) { return SaveLevel(level, w); });
-            writer.WriteEntry(level.FileName, levelData);
-            fmt::print("{}:{} ", level.FileName, levelData.size());
+        // The prefetch thread reads from the mission, which prevents replacing it on Windows.
+        // Prefetching resumes when the next level is requested after the mission is reloaded.
+        if (path == mission.Path)
+            LevelPrefetch::Clear();
 
-            auto levelMetadata = SerializeLevelMetadata(level);
-            writer.WriteEntry(metadataName, levelMetadata); // IED file
-            fmt::print("{}:{} ", metadataName, levelMetadata.size());
+        try {
+            auto updates = GetLevelHogEntries(level, mission, path);
+            bool inPlace = path == mission.Path && filesystem::exists(path) &&
+                !Seq::exists(mission.Entries, [](const HogEntry& e) { return e.IsImport(); });
 
-            if (level.IsVertigo() && !mission.ContainsFileType(".ham"))
-                AppendVertigoData(writer, path.stem().string() + ".ham");
+            if (inPlace) {
+                filesystem::copy_file(path, tempPath, filesystem::copy_options::overwrite_existing);
+                mission.WriteUpdate(tempPath, updates);
+            }
+            else {
+                HogWriter writer(tempPath); // write to temp
 
-            if (Resources::CustomTextures.Any()) {
-                if (mission.IsDescent1()) {
-                    auto dtx = SerializeToMemory([](StreamWriter& w) {
-                        return Resources::CustomTextures.WriteDtx(w, Resources::GetPalette());
-                    });
-                    writer.WriteEntry(baseName + ".dtx", dtx);
-                    fmt::print("{}:{} ", baseName + ".dtx", dtx.size());
-                }
-                else {
-                    auto pog = SerializeToMemory([](StreamWriter& w) {
-                        return Resources::CustomTextures.WritePog(w, Resources::GetPalette());
-                    });
-                    writer.WriteEntry(baseName + ".pog", pog);
-                    fmt::print("{}:{} ", baseName + ".pog", pog.size());
+                // Copy existing files that aren't replaced
+                for (auto& entry : mission.Entries) {
+                    if (Seq::exists(updates, [&entry](const HogUpdate& u) { return String::InvariantEquals(u.Name, entry.Name); }))
+                        continue;
+
+                    auto data = mission.ReadEntry(entry);
+                    writer.WriteEntry(entry.Name, data);
                 }
+
+                for (auto& update : updates)
+                    writer.WriteEntry(update.Name, update.Data);
             }
+
+            for (auto& update : updates)
+                fmt::print("{}:{} ", update.Name, update.Data.size());
+
+            ReplaceFromTemp(path, tempPath);
+            fmt::print("\n");
         }
         catch (const std::exception& e) {
             ShowErrorMessage(e);
             SPDLOG_ERROR(e.what());
-            return;
         }
+    }
 
-        BackupFile(path);
-        filesystem::remove(path); // Remove existing
-        filesystem::rename(tempPath, path); // Rename temp to destination
-        fmt::print("\n");
+    void SaveLevelsToHog(span<Level> levels, span<const LightSettings> lighting, HogFile& mission) {
+        assert(levels.size() == lighting.size());
+        List<HogUpdate> updates;
+
+        for (size_t i = 0; i < levels.size(); i++) {
+            auto& level = levels[i];
+            if (level.FileName.empty())
+                throw Exception("Level filename is empty!");
+
+            auto metadataName = String::NameWithoutExtension(level.FileName) + "." + METADATA_EXTENSION;
+            updates.push_back({ level.FileName, SerializeToMemory([&level](StreamWriter& w) { return SaveLevel(level, w); }, level.EstimateSerializedSize()) });
+            updates.push_back({ metadataName, SerializeLevelMetadata(level, lighting[i]) });
+        }
+
+        LevelPrefetch::Clear();
+
+        filesystem::path tempPath = mission.Path;
+        tempPath.replace_extension(".tmp");
+        filesystem::copy_file(mission.Path, tempPath, filesystem::copy_options::overwrite_existing);
+        mission.WriteUpdate(tempPath, updates);
+        ReplaceFromTemp(mission.Path, tempPath);
     }
 
     void LoadFile(filesystem::path path) {
@@ -283,17 +338,28 @@ namespace Inferno::Editor {
 
     void LoadLevelFromHOG(string name) {
         try {
-            auto level = Resources::ReadLevel(name);
-            level.FileName = name;
-            // Load metadata
-            auto metadataPath = String::NameWithoutExtension(level.FileName) + "." + METADATA_EXTENSION;
-            auto metadata = Game::Mission->TryReadEntry(metadataPath);
-            if (!metadata.empty()) {
-                string buffer((char*)metadata.data(), metadata.size());
-                LoadLevelMetadata(level, buffer);
+            if (auto prefetched = LevelPrefetch::Take(*Game::Mission, name)) {
+                auto& level = prefetched->Level;
+                if (!prefetched->Metadata.empty())
+                    LoadLevelMetadata(level, prefetched->Metadata, Settings::Editor.Lighting);
+
+                Game::LoadLevel(std::move(level));
+            }
+            else {
+                auto level = Resources::ReadLevel(name);
+                level.FileName = name;
+                // Load metadata
+                auto metadataPath = String::NameWithoutExtension(level.FileName) + "." + METADATA_EXTENSION;
+                auto metadata = Game::Mission->TryReadEntry(metadataPath);
+                if (!metadata.empty()) {
+                    string buffer((char*)metadata.data(), metadata.size());
+                    LoadLevelMetadata(level, buffer, Settings::Editor.Lighting);
+                }
+
+                Game::LoadLevel(std::move(level));
             }
 
-            Game::LoadLevel(std::move(level));
+            LevelPrefetch::Request(*Game::Mission, name);
         }
         catch (const std::exception& e) {
             ShowErrorMessage(e);
@@ -399,6 +465,7 @@ namespace Inferno::Editor {
                 WriteHog(level, *Game::Mission, *path);
                 auto srcMsn = Game::Mission->GetMissionPath(); // get the msn path before reloading
                 Game::LoadMission(*path);
+                LevelPrefetch::Request(*Game::Mission, level.FileName);
 
                 // copy the MSN if it existed
                 if (filesystem::exists(srcMsn)) {
@@ -434,6 +501,7 @@ namespace Inferno::Editor {
             assert(level.FileName != "");
             WriteHog(level, *Game::Mission, Game::Mission->Path);
             Game::LoadMission(Game::Mission->Path);
+            LevelPrefetch::Request(*Game::Mission, level.FileName);
             SetStatusMessage(L"Mission saved to {}", Game::Mission->Path.filename().wstring());
             Settings::Editor.AddRecentFile(Game::Mission->Path);
         }
@@ -543,11 +611,13 @@ namespace Inferno::Editor {
         }
 
         auto levelFileName = level.IsDescent1() ? "_test.rdl" : "_test.rl2";
-        auto levelData = SerializeToMemory([&level](StreamWriter& w) { return SaveLevel(level, w); });
+        auto levelData = SerializeToMemory([&level](StreamWriter& w) { return SaveLevel(level, w); }, level.EstimateSerializedSize());
         writer.WriteEntry(levelFileName, levelData);
 
-        if (level.IsVertigo() && !wroteHam)
-            AppendVertigoData(writer, "_test.ham");
+        if (level.IsVertigo() && !wroteHam) {
+            if (auto ham = ReadVertigoData(); !ham.empty())
+                writer.WriteEntry("_test.ham", ham);
+        }
 
         // Write the mission info file
         auto infoFile = level.IsDescent1() ? "_test.msn" : "_test.mn2";
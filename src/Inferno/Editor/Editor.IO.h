@@ -3,6 +3,7 @@
 #include "Level.h"
 #include "Command.h"
 #include "HogFile.h"
+#include "Settings.h"
 
 namespace Inferno::Editor {
     // Creates a backup of a file using the provided extension
@@ -13,6 +14,10 @@ namespace Inferno::Editor {
     void ResetAutosaveTimer();
     void WritePlaytestLevel(filesystem::path missionFolder, Level& level, HogFile* mission);
 
+    // Saves levels and their metadata into the mission file, leaving other entries untouched. Throws on failure.
+    // lighting holds the settings written to the metadata of each level.
+    void SaveLevelsToHog(span<Level> levels, span<const LightSettings> lighting, HogFile& mission);
+
     namespace Commands {
         extern Command ConvertToD2, ConvertToVertigo;
         extern Command NewLevel, Open, Save, SaveAs;
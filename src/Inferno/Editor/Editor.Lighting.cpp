@@ -5,7 +5,6 @@
 #include "Resources.h"
 #include "Game.h"
 #include "Editor.h"
-#include "ScopedTimer.h"
 #include "WindowsDialogs.h"
 
 namespace Inferno::Editor {
@@ -69,6 +68,7 @@ namespace Inferno::Editor {
         float LightPlaneTolerance = -0.45f;
         bool EnableOcclusion = true;
         float DynamicMultiplier = 1; // To reduce the intensity of flickering lights
+        uint64 InputHash = 0; // Hash of everything that affects the light, used to reuse previous bakes
 
         Color MaxBrightness() const {
             Color max;
@@ -78,19 +78,59 @@ namespace Inferno::Editor {
         }
     };
 
+    // Light values for every side vertex in the level, stored as one array per channel so that
+    // buffers can be merged with plain loops over floats. Indexed by (segment * 6 + side) * 4 + vertex.
+    struct SideLightBuffer {
+        List<float> R, G, B, A;
+
+        void Resize(size_t sides) {
+            for (auto channel : { &R, &G, &B, &A })
+                channel->assign(sides * 4, 0.0f);
+        }
+
+        bool Empty() const { return R.empty(); }
+
+        static size_t GetIndex(Tag tag, int vert) {
+            return DenseIndex<Tag>::ToIndex(tag) * 4 + vert;
+        }
+
+        void Add(size_t index, const Color& color) {
+            R[index] += color.x;
+            G[index] += color.y;
+            B[index] += color.z;
+            A[index] += color.w;
+        }
+
+        Color Get(size_t index) const {
+            return { R[index], G[index], B[index], A[index] };
+        }
+
+        void Reset(size_t index) {
+            R[index] = G[index] = B[index] = A[index] = 0;
+        }
+
+        // Adds the values of a buffer with the same size
+        void Add(const SideLightBuffer& src) {
+            assert(src.R.size() == R.size());
+
+            ParallelFor(R.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) R[i] += src.R[i];
+                for (size_t i = begin; i < end; i++) G[i] += src.G[i];
+                for (size_t i = begin; i < end; i++) B[i] += src.B[i];
+                for (size_t i = begin; i < end; i++) A[i] += src.A[i];
+            }, 4096);
+        }
+    };
+
     // light info during ray casting
     struct LightRayCast {
-        Dictionary<Tag, SideLighting> Accumulated; // Accumulated light for all passes
-        Dictionary<Tag, SideLighting> Pass; // Light for this pass, cleared after each iteration
+        List<Tuple<Tag, SideLighting>> Accumulated; // Accumulated light for all passes, sorted by tag
+        List<Tuple<Tag, SideLighting>> Pass; // Light for the last pass, sorted by tag
         // Maximum value of light in the pass.
         // This prevents faces adjacent to a light source exceeding the source brightness.
         Color PassMaxValue;
         const LightSource* Source = nullptr;
 
-        void AddLight(Tag tag, const Color& light, int16 point) {
-            Pass[tag][point] += light;
-        }
-
         void UpdateMaxValueFromPass(float reflectance) {
             Color max;
             for (auto& colors : Pass | views::values)
@@ -100,45 +140,121 @@ namespace Inferno::Editor {
 
             PassMaxValue = max * reflectance;
         }
+    };
 
-        // Accumulates lighting from the pass
-        void AccumulatePass(bool keep = true) {
-            for (auto& [dest, target] : Pass) {
-                for (auto& light : target)
-                    ClampColor(light, { 0, 0, 0, 0 }, PassMaxValue);
+    // Light transfer from the four vertices of a source side to the four vertices of a destination side.
+    // The light of a destination vertex is the sum of Coefficients[source vertex][dest vertex] * source color.
+    struct SideTransfer {
+        Tag Dest;
+        Array<Array<float, 4>, 4> Coefficients{};
+    };
 
-                auto& light = Accumulated[dest]; // will create in place if missing
+    // All sides reached by light from a single source side
+    struct TransferRow {
+        List<SideTransfer> Targets;
+    };
 
-                if (keep) {
-                    for (int i = 0; i < 4; i++)
-                        light[i] += target[i]; // change to assignment instead of sum to view the final pass contribution
-                }
-            }
+    // Source parameters that change the shape of the transfer
+    struct TransferKey {
+        Tag Source;
+        bool Bounce = false; // Bounces never use full brightness on the source side
+        float Radius = 0;
+        float LightPlaneTolerance = 0;
+        bool EnableOcclusion = true;
+
+        bool operator==(const TransferKey&) const = default;
+    };
+
+    struct TransferKeyHash {
+        size_t operator()(const TransferKey& key) const {
+            size_t hash = (size_t)key.Source.Segment * 6 + (size_t)key.Source.Side;
+            hash = hash * 31 + std::hash<float>{}(key.Radius);
+            hash = hash * 31 + std::hash<float>{}(key.LightPlaneTolerance);
+            return hash * 4 + key.Bounce * 2 + key.EnableOcclusion;
         }
     };
 
+    struct LightContext;
+
+    // Caches light transfers between lighting runs. Bounces and changes to light colors, multiplier,
+    // reflectance or ambient reuse the cached transfers instead of casting rays.
+    // Cleared when the geometry or the settings that affect visibility change.
+    // Stops caching new rows once the targets of all rows reach MAX_TARGETS.
+    class LightTransferCache {
+        Dictionary<TransferKey, std::shared_ptr<const TransferRow>, TransferKeyHash> _rows;
+        mutable std::shared_mutex _lock;
+        uint64 _inputHash = 0;
+        size_t _targets = 0; // Targets stored across all rows
+
+        static constexpr size_t MAX_TARGETS = 2'000'000; // About 130 MB
+
+    public:
+        // Clears the cache if the inputs changed since the last run
+        void Validate(uint64 inputHash) {
+            std::unique_lock lock(_lock);
+            if (inputHash == _inputHash) return;
+            _rows.clear();
+            _targets = 0;
+            _inputHash = inputHash;
+        }
+
+        void Clear() {
+            std::unique_lock lock(_lock);
+            _rows.clear();
+            _targets = 0;
+            _inputHash = 0;
+        }
+
+        size_t Size() const {
+            std::shared_lock lock(_lock);
+            return _rows.size();
+        }
+
+        // Returns the transfer for a source, building it if necessary. Thread safe.
+        // Rows built after the cache is full are returned without being stored.
+        std::shared_ptr<const TransferRow> Get(Level& level, const TransferKey& key, LightContext& ctx);
+    };
+
+    LightTransferCache TransferCache;
+
     // Self-contained unit of work
     struct LightContext {
-        Dictionary<Tag, LightRayCast> RayCasts;
+        List<LightRayCast> RayCasts; // One for each light
+
+        SideLightBuffer PassLight; // Light of the pass currently being cast
+        SideSet PassSides; // Sides touched by the current pass
+        SideLightBuffer TotalLight; // Accumulated light of all lights in the context
 
-        // Key is a combination of src seg, src vertex and dest vertex. Value indicates if dest is visible.
+        // Key is a combination of the src side, dest side and their corners. Value indicates if dest is visible.
         Dictionary<int64, bool> HitTests;
 
         List<LightSource> Lights;
         LightSettings Settings;
+        span<const uint8> VisibleSides; // Indexed by segment * 6 + side
         std::thread Thread;
         int CastStats = 0;
         int HitStats = 0;
         uint64 CacheHits = 0;
+        uint64 TransferHits = 0;
         int Id = 0;
 
         LightContext() {
             HitTests.reserve(100'000);
-            RayCasts.reserve(50);
         }
 
-        // Initial lighting pass from direct light sources
-        void EmitDirectLight(Level& level);
+        // Allocates the dense light buffers
+        void ResizeBuffers(const Level& level, bool passes) {
+            auto sides = level.Segments.size() * 6;
+            TotalLight.Resize(sides);
+
+            if (passes) {
+                PassLight.Resize(sides);
+                PassSides.Reserve(sides);
+            }
+        }
+
+        // Moves the pass light out of the dense buffer into the cast and adds it to the accumulated light
+        void AccumulatePass(LightRayCast& cast, bool keep = true);
     };
 
     // checks that there's enough light to bother saving. Prevents wasteful raycasts.
@@ -149,8 +265,8 @@ namespace Inferno::Editor {
 
     // Returns sides that are coplanar to the source within an angle
     List<Tag> FindCoplanarSides(const Level& level, Tag src, float thresholdAngle = 10.0f, bool sameTexture = false) {
-        Set<Tag> coplanar;
-        Set<Tag> scanned;
+        SideSet coplanar;
+        SideSet scanned;
         Stack<Tag> toScan;
         toScan.push(src);
 
@@ -291,10 +407,10 @@ namespace Inferno::Editor {
 
     // Returns segments that are within range and visible from the source surface.
     // Culls segments that are behind the plane of src.
-    Set<SegID> GetSegmentsInRange(Level& level, Tag src, float distanceThreshold) {
+    SegmentSet GetSegmentsInRange(Level& level, Tag src, float distanceThreshold) {
         auto srcFace = Face::FromSide(level, src);
 
-        Set<SegID> segmentsToLight;
+        SegmentSet segmentsToLight(level.Segments.size());
         segmentsToLight.insert(src.Segment);
 
         Stack<SegID> segmentsToSearch;
@@ -345,7 +461,7 @@ namespace Inferno::Editor {
     }
 
     // Returns true if the ray intersects any faces of the segment
-    bool HitTestRay(Level& level, const Set<SegID>& segments, const Ray& ray, float minDist, LightContext& ctx) {
+    bool HitTestRay(Level& level, const SegmentSet& segments, const Ray& ray, float minDist, LightContext& ctx) {
         for (auto& segId : segments) {
             const auto& seg = level.GetSegment(segId);
 
@@ -384,11 +500,22 @@ namespace Inferno::Editor {
         return false;
     }
 
+    // Returns true if geometry blocks the path between a light and a sample position
+    bool IsOccluded(Level& level, const SegmentSet& segments, const Vector3& lightPos, const Vector3& samplePos, LightContext& ctx) {
+        auto dir = samplePos - lightPos;
+        float minDist = dir.Length() - 0.01f; // minimum distance the light must travel. hitting something before this means a wall was in the way.
+        dir.Normalize();
+
+        // Direction length can be zero if segment has zero volume, assume it misses
+        Ray ray(lightPos, dir);
+        return dir.Length() != 0 ? HitTestRay(level, segments, ray, minDist, ctx) : false;
+    }
+
     // Returns true if geometry blocks the path between src point and light. Caches results.
     bool HitTest(Level& level,
-                 const Set<SegID>& segments,
-                 PointID destPoint,
-                 PointID lightPoint,
+                 const SegmentSet& segments,
+                 int destIndex,
+                 int lightIndex,
                  const Vector3& lightPos,
                  const Vector3& samplePos,
                  Tag src,
@@ -396,28 +523,15 @@ namespace Inferno::Editor {
                  LightContext& ctx) {
         if (src.Segment == dest.Segment) return false;
 
-        if ((int)src.Segment > 32767 || (int)dest.Segment > 32767 || (int)destPoint > 46339 || (int)lightPoint > 46339)
-            throw Exception("Lighting only supports up to 32767 segments and 46339 verts");
-
-        auto packedSegId = SzudzikPairing((uint16)src.Segment, (uint16)dest.Segment); // limited to 32767 (28 bit result)
-        auto packedPointId = SzudzikPairing(destPoint, lightPoint); // limited to 46339 (30 bit result)
-        uint64 id = (uint64)dest.Side << (28 + 30 + 3) | (uint64)src.Side << (28 + 30) | (uint64)packedPointId << 28 | (uint64)packedSegId;
-
-        //// Note that this packing breaks if there are more than 8191 segments in a level
-        //uint16 packedSrc = (uint16)src.Segment | ((uint16)src.Side << (16 - 3)); // pack side into the 3 high bits
-        //uint16 packedDest = (uint16)dest.Segment | ((uint16)dest.Side << (16 - 3)); // pack side into the 3 high bits
-        //uint64 id = (uint64)packedDest << 48 | (uint64)packedSrc << 32 | (uint64)destPoint << 16 | lightPoint;
+        // The samples only depend on the side and corner, so the key uses corner indices instead of vertex ids.
+        // Side indices get 30 bits each which covers any segment count a SegID can hold.
+        auto srcIndex = (uint64)DenseIndex<Tag>::ToIndex(src);
+        auto destSideIndex = (uint64)DenseIndex<Tag>::ToIndex(dest);
+        assert(srcIndex < (1 << 30) && destSideIndex < (1 << 30));
+        auto id = (int64)(srcIndex << 34 | destSideIndex << 4 | (uint64)lightIndex << 2 | (uint64)destIndex);
 
         if (!ctx.HitTests.contains(id)) {
-            auto dir = samplePos - lightPos;
-            float minDist = dir.Length() - 0.01f; // minimum distance the light must travel. hitting something before this means a wall was in the way.
-            dir.Normalize();
-
-            bool result = false;
-            // Direction length can be zero if segment has zero volume, assume it misses
-            Ray ray(lightPos, dir);
-            result = dir.Length() != 0 ? HitTestRay(level, segments, ray, minDist, ctx) : false;
-
+            auto result = IsOccluded(level, segments, lightPos, samplePos, ctx);
             ctx.HitTests[id] = result;
             return result;
         }
@@ -427,13 +541,13 @@ namespace Inferno::Editor {
         }
     }
 
-    void LightSegments(Level& level,
-                       const SideLighting& lightColors,
-                       Set<SegID> segmentsToLight,
-                       Tag src,
-                       bool bouncePass, // is this a bounce light pass?
-                       LightRayCast& cast,
-                       LightContext& ctx) {
+    // Builds the light transfer from a source side to every side it can reach.
+    // Only depends on geometry and the source parameters, not on the light color.
+    TransferRow BuildTransfer(Level& level, const TransferKey& key, LightContext& ctx) {
+        auto src = key.Source;
+        auto bouncePass = key.Bounce;
+        auto segmentsToLight = GetSegmentsInRange(level, src, ctx.Settings.DistanceThreshold);
+
         auto [srcSeg, srcSide] = level.GetSegmentAndSide(src);
         const auto srcFace = Face::FromSide(level, srcSeg, src.Side);
 
@@ -444,49 +558,74 @@ namespace Inferno::Editor {
         Array<Vector3, 4> lightPositions = srcFace.InsetTangent(0.5f, 1.01f);
         auto lightVertIds = srcSeg.GetVertexIndices(src.Side);
 
-        for (int lightIndex = 0; lightIndex < 4; lightIndex++) {
-            // for each light source
-            const auto& lightPos = lightPositions[lightIndex];
-            const auto& lightColor = lightColors[lightIndex];
-            if (!CheckMinLight(lightColor)) continue; // skip vert with no light
+        TransferRow row;
 
-            for (auto& destId : segmentsToLight) {
-                auto& destSeg = level.GetSegment(destId);
+        for (auto& destId : segmentsToLight) {
+            auto& destSeg = level.GetSegment(destId);
 
-                for (auto& destSideId : SideIDs) {
-                    // for each side in dest
-                    if (!ctx.Settings.AccurateVolumes && !SideIsVisible(level, destSeg, destSideId))
-                        continue; // skip invisible sides when accurate volumes is off
+            for (auto& destSideId : SideIDs) {
+                // for each side in dest
+                if (!ctx.VisibleSides[DenseIndex<Tag>::ToIndex({ destId, destSideId })])
+                    continue; // skip invisible sides
 
-                    const auto destVertIds = destSeg.GetVertexIndices(destSideId);
-                    const auto destFace = Face::FromSide(level, destId, destSideId);
-                    Tag dest = { destId, destSideId };
+                const auto destVertIds = destSeg.GetVertexIndices(destSideId);
+                const auto destFace = Face::FromSide(level, destId, destSideId);
+                Tag dest = { destId, destSideId };
 
-                    // Move occlusion sample points off of faces to improve light wrapping around corners
-                    auto destSamples =
-                        destSeg.IsZeroVolume(level) ?
-                        InsetTowardsPointPercentage(destFace.Center() + destFace.AverageNormal() * 5, destFace, 0.25f) :
-                        InsetTowardsPointPercentage(destSeg.Center, destFace, 0.1f);
+                // Move occlusion sample points off of faces to improve light wrapping around corners
+                auto destSamples =
+                    destSeg.IsZeroVolume(level) ?
+                    InsetTowardsPointPercentage(destFace.Center() + destFace.AverageNormal() * 5, destFace, 0.25f) :
+                    InsetTowardsPointPercentage(destSeg.Center, destFace, 0.1f);
 
-                    auto calcIntensity = [&](int vertIndex) {
+                SideTransfer transfer{ .Dest = dest };
+                bool hasLight = false;
+
+                auto hitTest = [&](int lightIndex, int vertIndex) {
+                    return HitTest(level, segmentsToLight, vertIndex, lightIndex, lightSamples[lightIndex], destSamples[vertIndex], src, dest, ctx);
+                };
+
+                // In adaptive mode the center to center ray and the opposite corners are tested first.
+                // If they agree the side is treated as fully lit or fully shadowed and the other samples are skipped.
+                Option<bool> uniformOcclusion;
+                bool probed = !ctx.Settings.AdaptiveOcclusion || src.Segment == dest.Segment;
+
+                auto isOccluded = [&](int lightIndex, int vertIndex) {
+                    if (!probed) {
+                        probed = true;
+                        auto lightCenter = (lightSamples[0] + lightSamples[1] + lightSamples[2] + lightSamples[3]) / 4;
+                        auto destCenter = (destSamples[0] + destSamples[1] + destSamples[2] + destSamples[3]) / 4;
+                        auto center = IsOccluded(level, segmentsToLight, lightCenter, destCenter, ctx);
+
+                        if (hitTest(0, 2) == center && hitTest(2, 0) == center &&
+                            hitTest(1, 3) == center && hitTest(3, 1) == center)
+                            uniformOcclusion = center;
+                    }
+
+                    return uniformOcclusion ? *uniformOcclusion : hitTest(lightIndex, vertIndex);
+                };
+
+                for (int lightIndex = 0; lightIndex < 4; lightIndex++) {
+                    // for each light source
+                    const auto& lightPos = lightPositions[lightIndex];
+                    auto& coefficients = transfer.Coefficients[lightIndex];
+
+                    auto calcAttenuation = [&](int vertIndex) {
                         bool fullBright = !bouncePass && (src == dest || Seq::contains(lightVertIds, destVertIds[vertIndex]));
                         auto dist = Vector3::Distance(destFace[vertIndex], lightPos); // use the real vertex position and not the sample for attenuation
-                        auto attenuation = fullBright ? 1 : Attenuate2(dist, cast.Source->Radius, ctx.Settings.Falloff);
-                        if (attenuation <= 0) return Color();
+                        auto attenuation = fullBright ? 1 : Attenuate2(dist, key.Radius, ctx.Settings.Falloff);
+                        if (attenuation <= 0) return 0.0f;
 
-                        if (cast.Source->EnableOcclusion &&
-                            HitTest(level, segmentsToLight, destVertIds[vertIndex], lightVertIds[lightIndex], lightSamples[lightIndex], destSamples[vertIndex], src, dest, ctx))
-                            return Color();
+                        if (key.EnableOcclusion && isOccluded(lightIndex, vertIndex))
+                            return 0.0f;
 
-                        auto multiplier = bouncePass ? ctx.Settings.Reflectance : ctx.Settings.Multiplier;
-                        return lightColor * attenuation * multiplier;
+                        return attenuation;
                     };
 
-                    //auto planeSamples = destFace.Inset(1, 1.01f);
                     auto checkPlanes = [&](int srcVertIndex, int destEdge) {
                         if (src.Segment != dest.Segment) {
                             // is the light behind the dest face?
-                            if (destFace.Distance(lightPos, destEdge) < cast.Source->LightPlaneTolerance) return false;
+                            if (destFace.Distance(lightPos, destEdge) < key.LightPlaneTolerance) return false;
                             // Is the vert behind the light?
                             if (srcFace.Distance(destFace[srcVertIndex], lightIndex) < PLANE_TOLERANCE) return false;
                         }
@@ -498,64 +637,115 @@ namespace Inferno::Editor {
                         for (int vertIndex = 0; vertIndex < 4; vertIndex++) {
                             // for each vert on side
                             if (!checkPlanes(vertIndex, vertIndex)) continue;
-                            auto intensity = calcIntensity(vertIndex);
-                            if (CheckMinLight(intensity))
-                                cast.Pass[dest][vertIndex] += intensity;
+                            coefficients[vertIndex] = calcAttenuation(vertIndex);
                         }
                     }
                     else {
                         // Light triangulated faces twice using the clip plane for each normal. Then average along seam.
-                        Color face0Color[4]{}, face1Color[4]{};
                         auto ri = destFace.Side.GetRenderIndices();
 
                         for (int i = 0; i < 3; i++) {
                             // for each vert of triangle 1
                             auto vertIndex = ri[i];
                             if (!checkPlanes(vertIndex, 0)) continue;
-                            face0Color[vertIndex] += calcIntensity(vertIndex);
+                            coefficients[vertIndex] += calcAttenuation(vertIndex);
                         }
 
                         for (int i = 3; i < 6; i++) {
                             // for each vert of triangle 2
                             auto vertIndex = ri[i];
                             if (!checkPlanes(vertIndex, 2)) continue;
-                            face1Color[vertIndex] += calcIntensity(vertIndex);
+                            coefficients[vertIndex] += calcAttenuation(vertIndex);
                         }
 
-                        for (int i = 0; i < 4; i++) {
-                            auto intensity = face0Color[i] + face1Color[i];
+                        // Average the shared edges
+                        if (destFace.Side.Type == SideSplitType::Tri02) {
+                            coefficients[0] *= 0.5f;
+                            coefficients[2] *= 0.5f;
+                        }
+                        else {
+                            coefficients[1] *= 0.5f;
+                            coefficients[3] *= 0.5f;
+                        }
+                    }
 
-                            // Average the shared edges
-                            if (destFace.Side.Type == SideSplitType::Tri02) {
-                                if (i == 0 || i == 2) intensity *= 0.5f;
-                            }
-                            else {
-                                if (i == 1 || i == 3) intensity *= 0.5f;
-                            }
+                    for (auto& c : coefficients)
+                        hasLight |= c > 0;
+                }
 
-                            if (CheckMinLight(intensity))
-                                cast.Pass[dest][i] += intensity;
-                        }
+                if (hasLight)
+                    row.Targets.push_back(transfer);
+            }
+        }
+
+        return row;
+    }
+
+    std::shared_ptr<const TransferRow> LightTransferCache::Get(Level& level, const TransferKey& key, LightContext& ctx) {
+        {
+            std::shared_lock lock(_lock);
+            if (auto row = _rows.find(key); row != _rows.end()) {
+                ctx.TransferHits++;
+                return row->second;
+            }
+        }
+
+        // Build outside of the lock so other threads can keep reading
+        auto row = std::make_shared<const TransferRow>(BuildTransfer(level, key, ctx));
+
+        std::unique_lock lock(_lock);
+        if (auto existing = _rows.find(key); existing != _rows.end())
+            return existing->second; // another thread built it first
+
+        if (_targets + row->Targets.size() > MAX_TARGETS)
+            return row; // full, don't cache
+
+        _targets += row->Targets.size();
+        _rows.emplace(key, row);
+        return row;
+    }
+
+    // Adds the light from a source side to the pass using its transfer
+    void ApplyTransfer(const TransferRow& row, const SideLighting& lightColors, float multiplier, LightContext& ctx) {
+        for (auto& target : row.Targets) {
+            for (int lightIndex = 0; lightIndex < 4; lightIndex++) {
+                const auto& lightColor = lightColors[lightIndex];
+                if (!CheckMinLight(lightColor)) continue; // skip vert with no light
+
+                for (int vert = 0; vert < 4; vert++) {
+                    auto coefficient = target.Coefficients[lightIndex][vert];
+                    if (coefficient <= 0) continue;
+
+                    auto intensity = lightColor * coefficient * multiplier;
+                    if (CheckMinLight(intensity)) {
+                        ctx.PassLight.Add(SideLightBuffer::GetIndex(target.Dest, vert), intensity);
+                        ctx.PassSides.insert(target.Dest);
                     }
                 }
             }
         }
     }
 
+    TransferKey GetTransferKey(Tag src, const LightSource& light, bool bounce) {
+        return {
+            .Source = src,
+            .Bounce = bounce,
+            .Radius = light.Radius,
+            .LightPlaneTolerance = light.LightPlaneTolerance,
+            .EnableOcclusion = light.EnableOcclusion
+        };
+    }
+
     LightRayCast& CastBounces(Level& level, LightRayCast& cast, LightContext& ctx) {
         cast.UpdateMaxValueFromPass(ctx.Settings.Reflectance);
 
         // Use the previous pass targets as the light sources
-        Dictionary<Tag, SideLighting> prevPass = std::move(cast.Pass);
-        cast.Pass = {};
-
-        for (const auto& [src, lightColors] : prevPass) {
+        for (const auto& [src, lightColors] : cast.Pass) {
             auto [srcSeg, srcSide] = level.GetSegmentAndSide(src);
 
-            // don't emit from open connections (from accurate volumes setting)
+            // don't emit from open connections
             if (srcSeg.SideHasConnection(src.Side) && !srcSeg.SideIsWall(src.Side)) continue;
 
-            Set<SegID> segmentsToLight = GetSegmentsInRange(level, src, ctx.Settings.DistanceThreshold);
             Color tmapColor = Resources::GetTextureInfo(srcSide.TMap).AverageColor;
             tmapColor.AdjustSaturation(2); // boost saturation to look nicer
             ScaleColor2(tmapColor, 1); // 100% brightness
@@ -563,29 +753,80 @@ namespace Inferno::Editor {
             for (auto& c : adjColors)
                 c *= tmapColor; // premultiply the texture color into the light color
 
-            LightSegments(level, adjColors, segmentsToLight, src, true, cast, ctx);
+            auto transfer = TransferCache.Get(level, GetTransferKey(src, *cast.Source, true), ctx);
+            ApplyTransfer(*transfer, adjColors, ctx.Settings.Reflectance, ctx);
         }
 
         return cast;
     }
 
     LightRayCast& CastDirectLight(Level& level, const LightSource& light, const LightSettings& settings, LightContext& ctx) {
-        Set<SegID> segmentsToLight = GetSegmentsInRange(level, light.Tag, settings.DistanceThreshold);
-
-        auto& cast = ctx.RayCasts[light.Tag];
+        auto& cast = ctx.RayCasts.emplace_back();
         cast.Source = &light;
         cast.PassMaxValue = light.MaxBrightness() * settings.Multiplier;
         // Clamp to the max light value setting
         ClampColor(cast.PassMaxValue, Color(0, 0, 0), Color(settings.MaxValue, settings.MaxValue, settings.MaxValue));
 
-        LightSegments(level, light.Colors, segmentsToLight, light.Tag, false, cast, ctx);
+        auto transfer = TransferCache.Get(level, GetTransferKey(light.Tag, light, false), ctx);
+        ApplyTransfer(*transfer, light.Colors, settings.Multiplier, ctx);
         return cast;
     }
 
+    void LightContext::AccumulatePass(LightRayCast& cast, bool keep) {
+        cast.Pass.clear();
+        cast.Pass.reserve(PassSides.size());
+
+        for (auto& tag : PassSides) {
+            SideLighting light;
+
+            for (int vert = 0; vert < 4; vert++) {
+                auto index = SideLightBuffer::GetIndex(tag, vert);
+                light[vert] = PassLight.Get(index);
+                PassLight.Reset(index);
+                ClampColor(light[vert], { 0, 0, 0, 0 }, cast.PassMaxValue);
+            }
+
+            cast.Pass.push_back({ tag, light });
+        }
+
+        PassSides.clear();
+        if (!keep) return;
+
+        // Merge the pass into the accumulated light. Both are sorted by tag.
+        List<Tuple<Tag, SideLighting>> merged;
+        merged.reserve(cast.Accumulated.size() + cast.Pass.size());
+        auto acc = cast.Accumulated.begin();
+
+        for (auto [tag, light] : cast.Pass) {
+            if (!Settings.EnableColor) {
+                for (auto& c : light)
+                    c.AdjustSaturation(0); // Remove all color from the results
+            }
+
+            for (int vert = 0; vert < 4; vert++)
+                TotalLight.Add(SideLightBuffer::GetIndex(tag, vert), light[vert]);
+
+            while (acc != cast.Accumulated.end() && acc->first < tag)
+                merged.push_back(*acc++);
+
+            if (acc != cast.Accumulated.end() && acc->first == tag) {
+                for (int vert = 0; vert < 4; vert++)
+                    light[vert] += acc->second[vert];
+
+                ++acc;
+            }
+
+            merged.push_back({ tag, light });
+        }
+
+        merged.insert(merged.end(), acc, cast.Accumulated.end());
+        cast.Accumulated = std::move(merged);
+    }
+
     // Reduces the intensity of touching co-planar light sources to make the
     // brightness consistent across the entire surface
     void ReduceCoplanarBrightness(const Level& level, span<LightSource> lights) {
-        Set<Tag> scanned;
+        SideSet scanned(level.Segments.size() * 6);
 
         for (auto& light : lights) {
             if (scanned.contains(light.Tag)) continue; // skip already scanned lights
@@ -660,33 +901,75 @@ namespace Inferno::Editor {
         return sources;
     }
 
-    void LightContext::EmitDirectLight(Level& level) {
-        for (auto& source : Lights) {
-            auto& cast = CastDirectLight(level, source, Settings, *this);
-            cast.AccumulatePass();
-        }
+    // Returns the visibility of every side in the level, indexed by segment * 6 + side
+    List<uint8> GetVisibleSides(const Level& level) {
+        List<uint8> visible(level.Segments.size() * 6);
+
+        ParallelFor(level.Segments.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                for (auto& sideId : SideIDs)
+                    visible[i * 6 + (int)sideId] = SideIsVisible(level, level.Segments[i], sideId);
+            }
+        });
+
+        return visible;
     }
 
-    // Calculates the volume light for all segments in the level based on surface lighting
-    void SetVolumeLight(Level& level, bool accurateVolumes) {
-        for (auto& seg : level.Segments) {
-            if (seg.LockVolumeLight) continue;
-            Color volume;
+    // Calculates the volume light for all segments in the level based on surface lighting.
+    // Accurate volumes also sample the surfaces of connected segments through open sides,
+    // which approximates the light passing through them without lighting the open sides.
+    void SetVolumeLight(Level& level, span<const uint8> visibleSides, bool accurateVolumes) {
+        // Average light of the visible sides of each segment
+        List<Color> surfaces(level.Segments.size());
+        List<uint8> hasSurface(level.Segments.size());
+
+        ParallelFor(level.Segments.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                Color sum;
+                int count = 0;
 
-            int contributingSides = 0;
-            // 6 sides with four color values
-            for (auto& sideId : SideIDs) {
-                if (!accurateVolumes && seg.SideHasConnection(sideId) && !seg.SideIsWall(sideId)) continue; // skip open sides unless accurate volumes enabled
-                auto& side = seg.GetSide(sideId);
-                for (auto& v : side.Light)
-                    volume += v;
-                contributingSides++;
+                for (int side = 0; side < 6; side++) {
+                    if (!visibleSides[i * 6 + side]) continue;
+                    for (auto& v : level.Segments[i].Sides[side].Light)
+                        sum += v;
+                    count++;
+                }
+
+                if (count == 0) continue;
+                surfaces[i] = sum * (1.0f / (count * 4));
+                hasSurface[i] = true;
             }
+        });
 
-            if (contributingSides == 0) continue;
-            seg.VolumeLight += volume * (1.0f / (contributingSides * 4));
-            seg.VolumeLight.A(1);
-        }
+        ParallelFor(level.Segments.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                auto& seg = level.Segments[i];
+                if (seg.LockVolumeLight) continue;
+
+                Color volume;
+                int contributingSides = 0;
+
+                for (auto& sideId : SideIDs) {
+                    if (visibleSides[i * 6 + (int)sideId]) {
+                        for (auto& v : seg.GetSide(sideId).Light)
+                            volume += v * 0.25f;
+
+                        contributingSides++;
+                    }
+                    else if (accurateVolumes) {
+                        // Light entering through the open side
+                        auto conn = seg.GetConnection(sideId);
+                        if (conn <= SegID::None || !hasSurface[(int)conn]) continue;
+                        volume += surfaces[(int)conn];
+                        contributingSides++;
+                    }
+                }
+
+                if (contributingSides == 0) continue;
+                seg.VolumeLight += volume * (1.0f / contributingSides);
+                seg.VolumeLight.A(1);
+            }
+        });
     }
 
     // Scales the brightness of values over 1 while retaining color
@@ -720,8 +1003,8 @@ namespace Inferno::Editor {
     }
 
     // Sets the initial brightness for all geometry in the level
-    void SetAmbientLight(Color ambient) {
-        for (auto& seg : Game::Level.Segments) {
+    void SetAmbientLight(Level& level, Color ambient) {
+        for (auto& seg : level.Segments) {
             for (auto& side : seg.Sides) {
                 for (int i = 0; i < 4; i++) {
                     if (side.LockLight[i]) continue;
@@ -737,66 +1020,97 @@ namespace Inferno::Editor {
         }
     }
 
-    // Generates the dynamic light table for destroyable and flickering lights
-    void SetDynamicLights(Level& level, const Dictionary<Tag, LightRayCast>& rayCasts) {
-        for (auto& [src, light] : rayCasts) {
-            if (!light.Source->IsDynamic) continue;
+    // Returns the brightest sides lit by a dynamic light, up to the per-light delta limit
+    List<LightDelta> GetLightDeltas(const Level& level, const LightRayCast& light) {
+        List<LightDelta> deltas;
+        deltas.reserve(light.Accumulated.size());
 
-            if (level.LightDeltaIndices.size() >= MaxDynamicLights) {
-                ShowWarningMessage(L"Maximum dynamic lights reached. Some lights will not work as expected.");
-                return;
-            }
+        for (auto& [dest, color] : light.Accumulated) {
+            if (AverageBrightness(color) < 0.005f) continue; // discard low brightness faces
 
-            if (level.LightDeltas.size() + MaxDeltasPerLight > MaxLightDeltas) {
-                ShowWarningMessage(L"Maximum light deltas reached. Some lights will not work as expected.");
-                return;
-            }
+            auto& seg = level.GetSegment(dest);
+            if (seg.SideHasConnection(dest.Side) && !seg.SideIsWall(dest.Side)) continue;
 
-            auto startIndex = (int16)level.LightDeltas.size();
+            deltas.push_back({ .Tag = dest, .Color = color });
+        }
 
-            // Sort light by brightness
-            struct Accumulated {
-                Tag Tag;
-                SideLighting Lighting;
-            };
-            auto accumulated = Seq::map(light.Accumulated, [](auto x) { return Accumulated{ x.first, x.second }; });
-            Seq::sortBy(accumulated, [](auto& a, auto& b) { return AverageBrightness(a.Lighting) > AverageBrightness(b.Lighting); });
+        // Sort light by brightness. Ties are ordered by tag so the results don't depend on hash order.
+        auto brighter = [](const LightDelta& a, const LightDelta& b) {
+            auto ab = AverageBrightness(a.Color), bb = AverageBrightness(b.Color);
+            return ab != bb ? ab > bb : a.Tag < b.Tag;
+        };
+
+        if (deltas.size() > MaxDeltasPerLight) {
+            SPDLOG_WARN("Reached delta limit for light {}-{}", light.Source->Tag.Segment, light.Source->Tag.Side);
+            // Only the brightest sides are kept, so there's no need to sort the rest
+            ranges::partial_sort(deltas, deltas.begin() + MaxDeltasPerLight, brighter);
+            deltas.resize(MaxDeltasPerLight);
+        }
+        else {
+            ranges::sort(deltas, brighter);
+        }
 
-            uint8 deltaCount = 0;
-            for (auto& [dest, color] : accumulated) {
-                if (AverageBrightness(color) < 0.005f) continue; // discard low brightness faces
+        for (auto& delta : deltas) {
+            for (auto& c : delta.Color) {
+                c *= light.Source->DynamicMultiplier;
+                c.A(0); // Don't affect alphas
+            }
+        }
 
-                if (light.Source->IsDynamic && deltaCount >= MaxDeltasPerLight) {
-                    SPDLOG_WARN("Reached delta limit for light {}-{}", light.Source->Tag.Segment, light.Source->Tag.Side);
-                    break;
-                }
+        return deltas;
+    }
 
-                auto& seg = level.GetSegment(dest);
-                if (seg.SideHasConnection(dest.Side) && !seg.SideIsWall(dest.Side)) continue;
+    // Generates the dynamic light table for destroyable and flickering lights.
+    // Deltas for each light are found in parallel and appended in order of the source tag.
+    // Returns a warning if the table limits were reached.
+    wstring SetDynamicLights(Level& level, span<const LightContext> contexts) {
+        List<const LightRayCast*> lights;
 
-                for (auto& c : color) c *= light.Source->DynamicMultiplier;
-                LightDelta ld = { .Tag = dest, .Color = color };
-                for (short i = 0; i < 4; i++) ld.Color[i].A(0); // Don't affect alphas
-                level.LightDeltas.push_back(ld);
-                deltaCount++;
+        for (auto& ctx : contexts) {
+            for (auto& light : ctx.RayCasts) {
+                if (light.Source->IsDynamic)
+                    lights.push_back(&light);
             }
+        }
+
+        ranges::sort(lights, {}, [](const LightRayCast* light) { return light->Source->Tag; });
+
+        List<List<LightDelta>> deltas(lights.size());
+        ParallelFor(lights.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                deltas[i] = GetLightDeltas(level, *lights[i]);
+        }, 8);
+
+        for (size_t i = 0; i < lights.size(); i++) {
+            if (level.LightDeltaIndices.size() >= MaxDynamicLights)
+                return L"Maximum dynamic lights reached. Some lights will not work as expected.";
+
+            if (level.LightDeltas.size() + MaxDeltasPerLight > MaxLightDeltas)
+                return L"Maximum light deltas reached. Some lights will not work as expected.";
 
             level.LightDeltaIndices.push_back(LightDeltaIndex{
-                .Tag = src,
-                .Count = deltaCount,
-                .Index = startIndex
+                .Tag = lights[i]->Source->Tag,
+                .Count = (uint8)deltas[i].size(),
+                .Index = (int16)level.LightDeltas.size()
             });
+
+            Seq::append(level.LightDeltas, deltas[i]);
         }
+
+        return {};
     }
 
     // Copies accumulated light to the level faces
-    void SetSideLighting(Level& level, const Dictionary<Tag, LightRayCast>& rayCasts, Color max, bool color) {
-        for (const auto& light : rayCasts | views::values) {
-            for (auto& [dest, l] : light.Accumulated) {
-                auto& side = level.GetSide(dest);
+    void SetSideLighting(Level& level, const SideLightBuffer& light, Color max, bool color) {
+        for (size_t segIndex = 0; segIndex < level.Segments.size(); segIndex++) {
+            auto& seg = level.Segments[segIndex];
+
+            for (auto& sideId : SideIDs) {
+                auto& side = seg.GetSide(sideId);
+
                 for (int vert = 0; vert < 4; vert++) {
                     if (side.LockLight[vert]) continue;
-                    side.Light[vert] += l[vert];
+                    side.Light[vert] += light.Get(SideLightBuffer::GetIndex({ SegID(segIndex), sideId }, vert));
                     if (!color)
                         ClampColor(side.Light[vert], { 0, 0, 0, 1 }, max); // clamp accumulated values to max
                 }
@@ -804,212 +1118,535 @@ namespace Inferno::Editor {
         }
     }
 
-    // Removes all color from results
-    void DesaturateAccumulated(Dictionary<Tag, LightRayCast>& rayCasts) {
-        for (auto& cast : rayCasts | views::values)
-            for (auto& side : cast.Accumulated | views::values)
-                for (auto& l : side)
-                    l.AdjustSaturation(0);
-    }
+    // Hashes the parts of each segment that affect light transfer: geometry, walls and
+    // the textures that light passes through
+    List<uint64> HashSegmentsForLighting(const Level& level) {
+        List<uint64> hashes(level.Segments.size());
+
+        ParallelFor(level.Segments.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                auto& seg = level.Segments[i];
+                Fnv1a hash;
+                hash.Append(seg.Connections);
+                hash.Append(seg.Indices);
+
+                for (auto& index : seg.Indices) {
+                    if (Seq::inRange(level.Vertices, index))
+                        hash.Append(level.Vertices[index]);
+                }
 
-    struct OctreeLeaf {
-        List<LightSource> Lights;
-        Array<Ptr<OctreeLeaf>, 8> Children;
-        DirectX::BoundingBox Bounds;
-        int Depth = 0;
-        static constexpr int MAX_DEPTH = 10;
-
-        void AddChildren(Level& level, const List<LightSource>& lights, int bucketSize) {
-            Lights = lights;
-
-            if (Depth >= MAX_DEPTH)
-                return; // prevent stack overflow due to stacked lights
-
-            Array<Vector3, DirectX::BoundingBox::CORNER_COUNT> corners;
-            Bounds.GetCorners(corners.data());
-            Dictionary<Tag, bool> used;
-
-            for (int i = 0; i < 8; i++) {
-                auto center = (Bounds.Center + corners[i]) / 2;
-                Children[i] = MakePtr<OctreeLeaf>();
-                auto& child = *Children[i];
-                child.Depth = Depth + 1;
-                child.Bounds = { center, Vector3(Bounds.Extents) / 2 };
-
-                for (auto& l : lights) {
-                    if (used.contains(l.Tag)) continue;
-                    auto face = Face::FromSide(level, l.Tag);
-                    if (child.Bounds.Contains(face.Center())) {
-                        used[l.Tag] = true;
-                        child.Lights.push_back(l);
+                for (auto& side : seg.Sides) {
+                    hash.Append(side.Type);
+                    hash.Append(side.Wall);
+                    hash.Append(side.TMap);
+                    hash.Append(side.TMap2);
+
+                    if (auto wall = level.TryGetWall(side.Wall)) {
+                        hash.Append(wall->Type);
+                        hash.Append(wall->BlocksLight.has_value());
+                        hash.Append(wall->BlocksLight.value_or(false));
                     }
                 }
 
-                if (child.Lights.size() > bucketSize)
-                    child.AddChildren(level, child.Lights, bucketSize);
+                hashes[i] = hash.Value;
+            }
+        });
+
+        return hashes;
+    }
+
+    // Hashes the segment topology and vertex positions that lighting results are indexed by
+    uint64 HashLevelGeometry(const Level& level) {
+        Fnv1a hash;
+        hash.Append(level.Segments.size());
+        hash.Append(level.Vertices.size());
+
+        for (auto& seg : level.Segments) {
+            hash.Append(seg.Connections);
+            hash.Append(seg.Indices);
+        }
+
+        for (auto& vert : level.Vertices)
+            hash.Append(vert);
 
-                if (Children[i]->Lights.empty())
-                    Children[i].reset(); // Free the node if it doesn't contain anything
+        return hash.Value;
+    }
+
+    // Hashes everything that affects light transfer
+    uint64 HashTransferInputs(span<const uint64> segmentHashes, const LightSettings& settings) {
+        Fnv1a hash;
+        hash.Append(settings.DistanceThreshold);
+        hash.Append(settings.Falloff);
+        hash.Append(settings.AdaptiveOcclusion);
+
+        for (auto& segHash : segmentHashes)
+            hash.Append(segHash);
+
+        return hash.Value;
+    }
+
+    // Returns the furthest distance light from a source can travel, including bounces
+    float GetLightReach(const Level& level, const LightSettings& settings) {
+        float maxSegmentSize = 0;
+
+        for (auto& seg : level.Segments) {
+            for (auto& index : seg.Indices) {
+                if (Seq::inRange(level.Vertices, index))
+                    maxSegmentSize = std::max(maxSegmentSize, Vector3::Distance(level.Vertices[index], seg.Center) * 2);
             }
         }
-    };
 
-    // Groups lights together into an axis aligned octree, stopping once bucket size is reached
-    OctreeLeaf CreateLightOctree(Level& level, const List<LightSource>& lights, int bucketSize) {
-        Vector3 minBounds = { FLT_MAX, FLT_MAX, FLT_MAX };
-        Vector3 maxBounds = { FLT_MIN, FLT_MIN, FLT_MIN };
+        // Each pass can travel the distance threshold from any point on the emitting segment
+        auto passes = std::clamp(settings.Bounces, 0, 10) + 1;
+        return passes * (settings.DistanceThreshold + maxSegmentSize);
+    }
 
-        for (auto& light : lights) {
-            auto face = Face::FromSide(level, light.Tag);
-            minBounds = VectorMin(minBounds, face.Center());
-            maxBounds = VectorMax(maxBounds, face.Center());
+    // Hashes the inputs of a single light: the source, the settings that affect the results
+    // and every segment the light can reach
+    uint64 HashLightInputs(const Level& level, const LightSource& light, const LightSettings& settings, span<const uint64> segmentHashes, float reach) {
+        Fnv1a hash;
+        hash.Append(light.Tag);
+        hash.Append(light.Indices);
+        hash.Append(light.Colors);
+        hash.Append(light.Radius);
+        hash.Append(light.LightPlaneTolerance);
+        hash.Append(light.EnableOcclusion);
+
+        hash.Append(settings.Multiplier);
+        hash.Append(settings.Reflectance);
+        hash.Append(settings.MaxValue);
+        hash.Append(settings.Bounces);
+        hash.Append(settings.SkipFirstPass);
+        hash.Append(settings.EnableColor);
+        hash.Append(settings.Falloff);
+        hash.Append(settings.DistanceThreshold);
+        hash.Append(settings.AdaptiveOcclusion);
+
+        auto& center = level.GetSegment(light.Tag).Center;
+        for (auto& id : level.GetSegmentGrid().FindInRadius(center, reach)) {
+            hash.Append(id);
+            hash.Append(segmentHashes[(int)id]);
         }
 
-        minBounds -= Vector3(10, 10, 10);
-        maxBounds += Vector3(10, 10, 10);
-        Vector3 center = (minBounds + maxBounds) / 2;
+        return hash.Value;
+    }
+
+    // Sorts lights along a z-order curve of the segment grid so that lights near each other
+    // end up next to each other in the list
+    void SortLightsByLocation(Level& level, List<LightSource>& lights) {
+        auto& grid = level.GetSegmentGrid();
+        List<Tuple<uint32, LightSource>> keyed;
+        keyed.reserve(lights.size());
 
-        OctreeLeaf tree;
-        tree.Bounds = DirectX::BoundingBox(center, maxBounds - center);
-        tree.AddChildren(level, lights, bucketSize);
-        return tree;
+        for (auto& light : lights)
+            keyed.push_back({ grid.GetCellKey(Face::FromSide(level, light.Tag).Center()), light });
+
+        ranges::stable_sort(keyed, {}, [](auto& x) { return x.first; });
+
+        for (size_t i = 0; i < lights.size(); i++)
+            lights[i] = std::move(keyed[i].second);
     }
 
-    // Lights the level geometry and volumes. Not thread safe (needs refactoring to not use globals).
-    void Commands::LightLevel(Level& level, const LightSettings& settings) {
-        try {
-            ScopedCursor cursor(IDC_WAIT);
-            Metrics::Reset();
-            level.LightDeltaIndices.clear();
-            level.LightDeltas.clear();
+    // Lighting values copied from the background job to the level after each pass
+    struct LightingResult {
+        List<SideLighting> SideLight; // Indexed by segment * 6 + side
+        List<Color> VolumeLight;
+        List<LightDeltaIndex> LightDeltaIndices;
+        List<LightDelta> LightDeltas;
+        Ref<Dictionary<Tag, LightBake>> LightBakes;
+        wstring Warning;
+        bool Final = false;
+
+        uint64 RaysCast = 0, RayHits = 0, CacheHits = 0, TransferHits = 0, CachedLights = 0;
+        int64 Time = 0;
+
+        // Copies the values into the level. Returns false if the segment count changed since the job started.
+        bool Apply(Level& level) const {
+            if (level.Segments.size() != VolumeLight.size()) return false;
+
+            for (size_t i = 0; i < level.Segments.size(); i++) {
+                auto& seg = level.Segments[i];
+                for (int side = 0; side < 6; side++)
+                    seg.Sides[side].Light = SideLight[i * 6 + side];
+
+                seg.VolumeLight = VolumeLight[i];
+                seg.LightSubtracted = 0;
+            }
 
-            ScopedTimer timer(&Metrics::LightCalculationTime);
+            if (Final) {
+                level.LightDeltaIndices = LightDeltaIndices;
+                level.LightDeltas = LightDeltas;
+                level.LightBakes = LightBakes;
+            }
 
-            auto hardwareThreads = std::thread::hardware_concurrency();
-            SPDLOG_INFO("Lighting level. {} available threads.", hardwareThreads);
-            auto availThreads = settings.Multithread && hardwareThreads > 1 ? hardwareThreads - 1 : 1; // leave 1 thread unused
+            return true;
+        }
 
-            SetAmbientLight(settings.Ambient);
+        static LightingResult FromLevel(const Level& level) {
+            LightingResult result;
+            result.SideLight.reserve(level.Segments.size() * 6);
+            result.VolumeLight.reserve(level.Segments.size());
 
-            auto lights = GatherLightSources(level, settings);
-            auto bucketSize = (int)std::max(lights.size() / availThreads, size_t(1));
+            for (auto& seg : level.Segments) {
+                for (auto& side : seg.Sides)
+                    result.SideLight.push_back(side.Light);
 
-            if (settings.CheckCoplanar)
-                ReduceCoplanarBrightness(level, lights);
+                result.VolumeLight.push_back(seg.VolumeLight);
+            }
 
-            List<LightContext> threads(availThreads);
-            int bucketIndex = 0;
+            return result;
+        }
+    };
 
-            // assign lights to threads based on their spatial locality
-            std::function<void(OctreeLeaf&)> addNodeLights = [&](const OctreeLeaf& leaf) {
-                if (bucketIndex >= threads.size()) {
-                    // ran out of buckets, dump everything into 0
-                    Seq::append(threads[0].Lights, leaf.Lights);
+    // Lights a copy of the level on a background thread. Results are published after the
+    // direct light pass and after each bounce so the editor can preview them.
+    class LightingJob {
+        Level _level;
+        LightSettings _settings;
+        LightingResult _original; // Lighting before the job started, restored on cancel
+        uint64 _geometryHash; // Geometry of the level when the job started
+        List<uint8> _visibleSides; // Indexed by segment * 6 + side
+        std::thread _thread;
+        std::atomic<bool> _cancel = false;
+        std::atomic<bool> _finished = false;
+        std::atomic<size_t> _completedSteps = 0;
+        std::atomic<size_t> _totalSteps = 1;
+
+        std::mutex _resultLock;
+        Ptr<LightingResult> _pending; // Latest published result not yet applied to the level
+
+        std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+
+    public:
+        LightingJob(const Level& level, const LightSettings& settings)
+            : _level(level), _settings(settings), _original(LightingResult::FromLevel(level)),
+              _geometryHash(HashLevelGeometry(level)) {
+            _thread = std::thread([this] {
+                try {
+                    Run();
                 }
-                else if (leaf.Lights.size() <= bucketSize) {
-                    // lights in this leaf fit into a bucket
-                    Seq::append(threads[bucketIndex].Lights, leaf.Lights);
-                    if (threads[bucketIndex].Lights.size() >= bucketSize)
-                        bucketIndex++;
+                catch (const std::exception& e) {
+                    SPDLOG_ERROR("Error while lighting level: {}", e.what());
                 }
-                else {
-                    for (int i = 0; i < 8; i++) {
-                        if (leaf.Children[i]) {
-                            addNodeLights(*leaf.Children[i]);
-                        }
-                    }
-                }
-            };
 
-            auto tree = CreateLightOctree(level, lights, bucketSize);
-            addNodeLights(tree);
-            Seq::sortBy(threads, [](const LightContext& a, const LightContext& b) {
-                return a.Lights.size() > b.Lights.size();
+                _finished = true;
             });
+        }
+
+        ~LightingJob() {
+            Cancel();
+            if (_thread.joinable())
+                _thread.join();
+        }
+
+        LightingJob(const LightingJob&) = delete;
+        LightingJob(LightingJob&&) = delete;
+        LightingJob& operator=(const LightingJob&) = delete;
+        LightingJob& operator=(LightingJob&&) = delete;
+
+        void Cancel() { _cancel = true; }
+
+        // Blocks until the job finishes or is cancelled
+        void Wait() {
+            if (_thread.joinable())
+                _thread.join();
+        }
+        bool IsCancelled() const { return _cancel; }
+        bool IsFinished() const { return _finished; }
+
+        float GetProgress() const {
+            return std::min((float)_completedSteps / (float)_totalSteps, 1.0f);
+        }
+
+        const LightingResult& GetOriginal() const { return _original; }
+
+        // Results are indexed by segment and side, so they only apply to the geometry the job started with
+        bool MatchesGeometry(const Level& level) const {
+            return HashLevelGeometry(level) == _geometryHash;
+        }
+
+        // Takes the latest published result, if any
+        Ptr<LightingResult> TakeResult() {
+            std::scoped_lock lock(_resultLock);
+            return std::move(_pending);
+        }
+
+    private:
+        void Publish(span<const LightContext> contexts, bool final);
+        void Run();
+    };
+
+    Ptr<LightingJob> ActiveLightingJob;
+
+    // Composes the lighting from all contexts into the level copy and publishes it
+    void LightingJob::Publish(span<const LightContext> contexts, bool final) {
+        auto& level = _level;
+        SetAmbientLight(level, _settings.Ambient);
+
+        auto maxValue = std::clamp(_settings.MaxValue, 0.0f, 10.0f);
+        const Color max = { maxValue, maxValue, maxValue, 1 };
+
+        auto result = MakePtr<LightingResult>();
+        wstring warning;
+
+        if (final) {
+            level.LightDeltaIndices.clear();
+            level.LightDeltas.clear();
+            result->LightBakes = MakeRef<Dictionary<Tag, LightBake>>();
+        }
+
+        // Reduce the light from each context
+        SideLightBuffer total;
+        total.Resize(level.Segments.size() * 6);
+
+        for (auto& ctx : contexts) {
+            if (!ctx.TotalLight.Empty())
+                total.Add(ctx.TotalLight);
 
-            // Count the number of empty and filled threads
-            int emptyThreads = 0, filledThreads = 0;
-            for (auto& thread : threads) {
-                if (thread.Lights.empty())
-                    emptyThreads++;
-                else
-                    filledThreads++;
+            result->CacheHits += ctx.CacheHits;
+            result->TransferHits += ctx.TransferHits;
+            result->RayHits += ctx.HitStats;
+            result->RaysCast += ctx.CastStats;
+
+            if (final) {
+                for (auto& cast : ctx.RayCasts) {
+                    auto& bake = (*result->LightBakes)[cast.Source->Tag];
+                    bake.Hash = cast.Source->InputHash;
+                    bake.Accumulated = cast.Accumulated;
+                }
             }
+        }
+
+        SetSideLighting(level, total, max, _settings.EnableColor);
+        if (_settings.EnableColor)
+            ClampColorBrightness(level, _settings.MaxValue);
+
+        if (final)
+            warning = SetDynamicLights(level, contexts);
+
+        SetVolumeLight(level, _visibleSides, _settings.AccurateVolumes);
+
+        auto values = LightingResult::FromLevel(level);
+        result->SideLight = std::move(values.SideLight);
+        result->VolumeLight = std::move(values.VolumeLight);
+        result->CachedLights = contexts.empty() ? 0 : contexts[0].Lights.size();
+        result->Time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count();
+        result->Final = final;
+
+        if (final) {
+            result->LightDeltaIndices = level.LightDeltaIndices;
+            result->LightDeltas = level.LightDeltas;
+            result->Warning = warning;
+            SPDLOG_INFO("Delta lights: {} of {}\nIndices: {} of {}", level.LightDeltaIndices.size(), MaxDynamicLights, level.LightDeltas.size(), MaxLightDeltas);
+        }
+
+        std::scoped_lock lock(_resultLock);
+        _pending = std::move(result);
+    }
+
+    void LightingJob::Run() {
+        auto& level = _level;
+        auto& settings = _settings;
+
+        auto hardwareThreads = std::thread::hardware_concurrency();
+        SPDLOG_INFO("Lighting level. {} available threads.", hardwareThreads);
+        auto availThreads = settings.Multithread && hardwareThreads > 1 ? hardwareThreads - 1 : 1; // leave 1 thread unused
+
+        auto segmentHashes = HashSegmentsForLighting(level);
+        _visibleSides = GetVisibleSides(level);
+        TransferCache.Validate(HashTransferInputs(segmentHashes, settings));
 
-            // Fill empty threads by splitting large buckets
-            for (int i = 0; i < emptyThreads; i++) {
-                auto& src = threads[i].Lights;
-                auto& dst = threads[filledThreads + i].Lights;
-                // move half of the lights to a new thread
-                auto len = src.size() / 2;
-                std::move(src.begin() + len, src.end(), std::back_inserter(dst));
-                src.resize(src.size() - dst.size());
-                //assert(originalLen == src.size() + dst.size());
+        auto lights = GatherLightSources(level, settings);
+
+        if (settings.CheckCoplanar)
+            ReduceCoplanarBrightness(level, lights);
+
+        // The first context holds the lights restored from the previous bake.
+        // The rest are worker threads.
+        List<LightContext> contexts(availThreads + 1);
+        auto& cached = contexts[0];
+
+        // Reuse the previous bake for lights whose inputs didn't change
+        {
+            auto reach = GetLightReach(level, settings);
+            List<LightSource> changed;
+
+            for (auto& light : lights) {
+                light.InputHash = HashLightInputs(level, light, settings, segmentHashes, reach);
+
+                if (level.LightBakes) {
+                    auto bake = level.LightBakes->find(light.Tag);
+                    if (bake != level.LightBakes->end() && bake->second.Hash == light.InputHash) {
+                        cached.Lights.push_back(light);
+                        continue;
+                    }
+                }
+
+                changed.push_back(light);
             }
 
-            // If single threaded, preallocate a single large buffer
-            if (availThreads == 1) {
-                threads[0].HitTests = Dictionary<int64, bool>{ 1'000'000 };
-                threads[0].RayCasts = Dictionary<Tag, LightRayCast>{ 1000 };
+            cached.ResizeBuffers(level, false);
+            cached.RayCasts.reserve(cached.Lights.size());
+
+            for (auto& light : cached.Lights) {
+                auto& cast = cached.RayCasts.emplace_back();
+                cast.Source = &light;
+                cast.Accumulated = level.LightBakes->at(light.Tag).Accumulated;
+                ranges::sort(cast.Accumulated, {}, [](auto& x) { return x.first; });
+
+                for (auto& [dest, color] : cast.Accumulated) {
+                    for (int vert = 0; vert < 4; vert++)
+                        cached.TotalLight.Add(SideLightBuffer::GetIndex(dest, vert), color[vert]);
+                }
             }
 
-            // Dispatch worker threads
-            std::atomic activeThreads = 0;
-            for (auto& ctx : threads) {
-                if (ctx.Lights.empty()) continue;
+            lights = std::move(changed);
+        }
 
-                ctx.Settings = settings;
-                ctx.Id = activeThreads++;
+        auto threads = span(contexts).subspan(1);
 
-                // Accumulate radiosity bounces
-                ctx.Thread = std::thread([&ctx, &level] {
-                    SPDLOG_INFO("Dispatching thread {} with {} lights", ctx.Id, ctx.Lights.size());
-                    ctx.EmitDirectLight(level);
+        // assign lights to threads based on their spatial locality
+        SortLightsByLocation(level, lights);
 
-                    auto bounces = std::clamp(ctx.Settings.Bounces, 0, 10);
+        for (size_t i = 0; i < threads.size(); i++) {
+            auto begin = lights.size() * i / threads.size();
+            auto end = lights.size() * (i + 1) / threads.size();
+            threads[i].Lights.assign(lights.begin() + begin, lights.begin() + end);
+            threads[i].Settings = settings;
+            threads[i].VisibleSides = _visibleSides;
+            threads[i].Id = (int)i;
+            threads[i].RayCasts.reserve(threads[i].Lights.size());
 
-                    for (int i = 0; i < bounces; i++) {
-                        for (auto& light : ctx.RayCasts | views::values) {
-                            auto& info = CastBounces(level, light, ctx);
-                            info.AccumulatePass(!(ctx.Settings.SkipFirstPass && i == 0));
-                        }
-                    }
+            if (!threads[i].Lights.empty())
+                threads[i].ResizeBuffers(level, true);
+        }
 
-                    if (!ctx.Settings.EnableColor)
-                        DesaturateAccumulated(ctx.RayCasts);
+        // If single threaded, preallocate a single large buffer
+        if (availThreads == 1)
+            threads[0].HitTests = Dictionary<int64, bool>{ 1'000'000 };
 
-                    SPDLOG_INFO("Thread {} finished. Lights: {} Cache size: {}", ctx.Id, ctx.Lights.size(), ctx.HitTests.size());
-                });
+        auto bounces = std::clamp(settings.Bounces, 0, 10);
+        _totalSteps = std::max(lights.size() * (bounces + 1), (size_t)1);
+
+        // Runs a pass on every thread and waits for them to finish
+        auto runPass = [&](auto&& pass) {
+            for (auto& ctx : threads) {
+                if (ctx.Lights.empty()) continue;
+                ctx.Thread = std::thread([&ctx, &pass] { pass(ctx); });
             }
 
             for (auto& ctx : threads) {
                 if (ctx.Thread.joinable())
                     ctx.Thread.join();
             }
+        };
 
-            auto maxValue = std::clamp(settings.MaxValue, 0.0f, 10.0f);
-            const Color max = { maxValue, maxValue, maxValue, 1 };
+        runPass([&](LightContext& ctx) {
+            SPDLOG_INFO("Dispatching thread {} with {} lights", ctx.Id, ctx.Lights.size());
 
-            // Merge the results from each light
-            for (auto& ctx : threads) {
-                // updating the level must be done in serial
-                SetSideLighting(level, ctx.RayCasts, max, settings.EnableColor);
-                if (settings.EnableColor)
-                    ClampColorBrightness(level, settings.MaxValue);
+            for (auto& source : ctx.Lights) {
+                if (_cancel) return;
+                auto& cast = CastDirectLight(level, source, ctx.Settings, ctx);
+                ctx.AccumulatePass(cast);
+                _completedSteps++;
+            }
+        });
+
+        if (_cancel) return;
+        Publish(contexts, bounces == 0);
+
+        // Accumulate radiosity bounces
+        for (int i = 0; i < bounces; i++) {
+            runPass([&](LightContext& ctx) {
+                for (auto& cast : ctx.RayCasts) {
+                    if (_cancel) return;
+                    CastBounces(level, cast, ctx);
+                    ctx.AccumulatePass(cast, !(ctx.Settings.SkipFirstPass && i == 0));
+                    _completedSteps++;
+                }
+            });
+
+            if (_cancel) return;
+            Publish(contexts, i == bounces - 1);
+            SPDLOG_INFO("Finished bounce {} of {}", i + 1, bounces);
+        }
+    }
+
+    // Starts lighting a copy of the level in the background. Restarts any bake already in progress.
+    void Commands::LightLevel(Level& level, const LightSettings& settings) {
+        CancelLighting(level);
+        Metrics::Reset();
+        ActiveLightingJob = MakePtr<LightingJob>(level, settings);
+    }
+
+    void AbortLighting() {
+        ActiveLightingJob.reset();
+    }
+
+    wstring LightLevelAndWait(Level& level, const LightSettings& settings) {
+        LightingJob job(level, settings);
+        job.Wait();
+
+        // Intermediate results are replaced as they are published, so only the final result remains
+        auto result = job.TakeResult();
+        if (!result || !result->Final)
+            throw Exception("Lighting did not finish");
 
-                SetDynamicLights(level, ctx.RayCasts);
-                Metrics::CacheHits += ctx.CacheHits;
-                Metrics::RayHits += ctx.HitStats;
-                Metrics::RaysCast += ctx.CastStats;
+        result->Apply(level);
+        return result->Warning;
+    }
+
+    void Commands::CancelLighting(Level& level) {
+        if (!ActiveLightingJob) return;
+
+        ActiveLightingJob->Cancel();
+        bool restored = ActiveLightingJob->MatchesGeometry(level) && ActiveLightingJob->GetOriginal().Apply(level);
+        ActiveLightingJob.reset(); // joins the thread
+
+        if (restored)
+            Events::LevelChanged();
+    }
+
+    bool LightingInProgress() {
+        return ActiveLightingJob != nullptr;
+    }
+
+    float GetLightingProgress() {
+        return ActiveLightingJob ? ActiveLightingJob->GetProgress() : 0;
+    }
+
+    void UpdateLighting(Level& level) {
+        if (!ActiveLightingJob) return;
+
+        if (auto result = ActiveLightingJob->TakeResult()) {
+            if (!ActiveLightingJob->MatchesGeometry(level) || !result->Apply(level)) {
+                SPDLOG_WARN("Level geometry changed while lighting, cancelling");
+                ActiveLightingJob.reset();
+                return;
             }
 
-            SetVolumeLight(level, settings.AccurateVolumes);
+            Metrics::RaysCast = result->RaysCast;
+            Metrics::RayHits = result->RayHits;
+            Metrics::CacheHits = result->CacheHits;
+            Metrics::TransferHits = result->TransferHits;
+            Metrics::CachedLights = result->CachedLights;
+            Metrics::LightCalculationTime = result->Time;
+            Events::LevelChanged();
 
-            SPDLOG_INFO("Delta lights: {} of {}\nIndices: {} of {}", level.LightDeltaIndices.size(), MaxDynamicLights, level.LightDeltas.size(), MaxLightDeltas);
-            Editor::History.SnapshotLevel("Light Level");
+            if (result->Final) {
+                ActiveLightingJob.reset();
+                Editor::History.SnapshotLevel("Light Level");
+
+                if (!result->Warning.empty())
+                    ShowWarningMessage(result->Warning);
+            }
+
+            return;
         }
-        catch (const std::exception& e) {
-            ShowErrorMessage(e);
+
+        if (ActiveLightingJob->IsFinished()) {
+            // Stopped without publishing final results due to an error
+            ActiveLightingJob.reset();
         }
     }
 }
@@ -7,18 +7,41 @@ namespace Inferno::Editor {
         inline uint64 RaysCast = 0;
         inline uint64 RayHits = 0;
         inline uint64 CacheHits = 0;
+        inline uint64 TransferHits = 0; // Light transfers reused from a previous pass or run
+        inline uint64 CachedLights = 0; // Lights reused from the previous bake
 
         inline int64 LightCalculationTime = 0;
 
         inline void Reset() {
-            RaysCast = RayHits = CacheHits = 0;
+            RaysCast = RayHits = CacheHits = TransferHits = CachedLights = 0;
             LightCalculationTime = 0;
         }
     };
 
     Color GetLightColor(const SegmentSide& side, bool enableColor);
 
+    // Returns true while lighting is being calculated in the background
+    bool LightingInProgress();
+
+    // Returns the progress of the background lighting from 0 to 1
+    float GetLightingProgress();
+
+    // Copies results published by the background lighting into the level. Call once per frame.
+    void UpdateLighting(Level&);
+
+    // Stops the background lighting without modifying the level and waits for its threads to exit.
+    // Called before the game data is reloaded because the lighting threads read it.
+    void AbortLighting();
+
+    // Lights the level on worker threads and blocks until finished. Returns a warning if a limit was exceeded.
+    wstring LightLevelAndWait(Level&, const LightSettings&);
+
     namespace Commands {
+        // Lights a copy of the level in the background. Intermediate results are copied
+        // into the level by UpdateLighting() after the direct light and each bounce.
         void LightLevel(Level&, const LightSettings&);
+
+        // Stops the background lighting and restores the previous lighting
+        void CancelLighting(Level&);
     }
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "pch.h"
+#include "logging.h"
+#include "Editor.Prefetch.h"
+#include "WorkerThread.h"
+#include "Resources.h"
+#include "Game.h"
+#include "LevelSettings.h"
+#include "Graphics/MaterialLibrary.h"
+
+namespace Inferno::Editor::LevelPrefetch {
+    namespace {
+        struct Entry {
+            string Name;
+            HogEntry Source; // Location in the mission when it was read
+            filesystem::file_time_type WriteTime;
+            Option<PrefetchedLevel> Level;
+            bool TexturesRequested = false;
+            bool Failed = false; // Couldn't be read or decoded. Not retried until requested again.
+        };
+
+        class PrefetchWorker : public WorkerThread {
+            std::mutex _lock;
+            std::mutex _readLock; // Held while the worker reads from the mission file
+            Option<HogFile> _mission; // copy of the mission so reads don't race with saves
+            List<Entry> _entries;
+
+        public:
+            void Request(const HogFile& mission, const List<string>& names) {
+                {
+                    std::scoped_lock lock(_lock);
+                    bool sameMission = _mission && _mission->Path == mission.Path;
+                    _mission = mission;
+
+                    // Keep levels that are still wanted and were read from the same file
+                    std::erase_if(_entries, [&](const Entry& entry) {
+                        return !sameMission || entry.Failed || !Seq::contains(names, entry.Name);
+                    });
+
+                    for (auto& name : names) {
+                        if (!Seq::exists(_entries, [&name](const Entry& e) { return e.Name == name; }))
+                            _entries.push_back({ name });
+                    }
+                }
+
+                Notify();
+            }
+
+            Option<PrefetchedLevel> Take(const HogFile& mission, const string& name) {
+                std::scoped_lock lock(_lock);
+                auto index = Seq::findIndex(_entries, [&name](const Entry& e) { return e.Name == name; });
+                if (!index) return {};
+
+                auto entry = std::move(_entries[*index]);
+                _entries.erase(_entries.begin() + *index);
+                if (!entry.Level) return {}; // not ready yet
+
+                // Discard the level if the mission was saved or replaced after it was read
+                std::error_code ec;
+                auto current = mission.TryFindEntry(name);
+                if (!current || mission.Path != _mission->Path ||
+                    current->Offset != entry.Source.Offset || current->Size != entry.Source.Size ||
+                    filesystem::last_write_time(mission.Path, ec) != entry.WriteTime)
+                    return {};
+
+                return std::move(entry.Level);
+            }
+
+            // Calls fn(const Level&) once for each level that finished prefetching
+            void ForEachNewLevel(auto&& fn) {
+                std::scoped_lock lock(_lock);
+
+                for (auto& entry : _entries) {
+                    if (!entry.Level || entry.TexturesRequested) continue;
+                    entry.TexturesRequested = true;
+                    fn(entry.Level->Level);
+                }
+            }
+
+            // Discards all entries and waits for a read in progress to finish, so the mission file can be replaced
+            void Clear() {
+                {
+                    std::scoped_lock lock(_lock);
+                    _entries.clear();
+                    _mission = {};
+                }
+
+                std::scoped_lock read(_readLock);
+            }
+
+        protected:
+            void Work() override {
+                while (!HasWork()) {
+                    std::scoped_lock read(_readLock);
+                    string name;
+                    HogFile mission;
+
+                    {
+                        std::scoped_lock lock(_lock);
+                        auto entry = Seq::find(_entries, [](const Entry& e) { return !e.Level && !e.Failed; });
+                        if (!entry || !_mission) return;
+                        name = entry->Name;
+                        mission = *_mission;
+                    }
+
+                    std::error_code ec;
+                    auto writeTime = filesystem::last_write_time(mission.Path, ec);
+                    HogEntry source;
+                    PrefetchedLevel prefetched;
+
+                    try {
+                        source = mission.FindEntry(name);
+                        auto data = mission.ReadEntry(source);
+                        prefetched.Level = Level::Deserialize(data);
+                        prefetched.Level.FileName = name;
+
+                        auto metadata = mission.TryReadEntry(String::NameWithoutExtension(name) + "." + METADATA_EXTENSION);
+                        prefetched.Metadata = string((char*)metadata.data(), metadata.size());
+                    }
+                    catch (const std::exception& e) {
+                        SPDLOG_WARN("Unable to prefetch level {}: {}", name, e.what());
+
+                        // Mark the entry so the loop moves on instead of reading it again
+                        std::scoped_lock lock(_lock);
+                        if (auto failed = Seq::find(_entries, [&name](const Entry& x) { return x.Name == name; }))
+                            failed->Failed = true;
+
+                        continue;
+                    }
+
+                    std::scoped_lock lock(_lock);
+                    // The request could have changed while reading
+                    if (auto entry = Seq::find(_entries, [&name](const Entry& e) { return e.Name == name; });
+                        entry && _mission && _mission->Path == mission.Path) {
+                        entry->Source = source;
+                        entry->WriteTime = writeTime;
+                        entry->Level = std::move(prefetched);
+                        SPDLOG_INFO("Prefetched level {}", name);
+                    }
+                }
+            }
+        };
+
+        Ptr<PrefetchWorker> Worker;
+    }
+
+    void Request(const HogFile& mission, const string& current) {
+        auto levels = mission.GetLevels();
+        Seq::sortBy(levels, [](HogEntry& a, HogEntry& b) { return a.Name < b.Name; });
+
+        auto index = Seq::findIndex(levels, [&current](const HogEntry& e) { return String::InvariantEquals(e.Name, current); });
+        if (!index) return;
+
+        List<string> names;
+        if (*index + 1 < levels.size()) names.push_back(levels[*index + 1].Name);
+        if (*index > 0) names.push_back(levels[*index - 1].Name);
+
+        if (!Worker) {
+            Worker = MakePtr<PrefetchWorker>();
+            Worker->Start();
+        }
+
+        Worker->Request(mission, names);
+    }
+
+    Option<PrefetchedLevel> Take(const HogFile& mission, const string& name) {
+        if (!Worker) return {};
+        return Worker->Take(mission, name);
+    }
+
+    void Update() {
+        if (!Worker || !Render::Materials) return;
+
+        Worker->ForEachNewLevel([](const Level& level) {
+            // Textures are looked up through the loaded game data, which only matches levels of the same game
+            if (level.IsDescent2() != Game::Level.IsDescent2() ||
+                !String::InvariantEquals(level.Palette, Game::Level.Palette) ||
+                Resources::CustomTextures.Any())
+                return;
+
+            // Keep the textures through prunes so switching to the level doesn't upload them again
+            auto ids = Render::GetLevelTextures(level, Render::Materials->PreloadDoors);
+            Seq::insert(Render::Materials->KeepLoaded, ids);
+            Render::Materials->LoadMaterialsAsync(Seq::ofSet(ids));
+        });
+    }
+
+    void Clear() {
+        if (Worker) Worker->Clear();
+    }
+
+    void Shutdown() {
+        if (!Worker) return;
+        Worker->Stop();
+        Worker.reset();
+    }
+}
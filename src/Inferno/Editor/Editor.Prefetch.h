@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Types.h"
+#include "Level.h"
+#include "HogFile.h"
+
+namespace Inferno::Editor {
+    // Reads and decodes the levels next to the open level of a mission on a background thread,
+    // so switching to them skips reading the HOG and decoding the level.
+    namespace LevelPrefetch {
+        struct PrefetchedLevel {
+            Inferno::Level Level;
+            string Metadata; // Contents of the IED file. Parsed when taken because it changes editor settings.
+        };
+
+        // Starts prefetching the previous and next levels of the mission. Called after a mission level is loaded.
+        void Request(const HogFile& mission, const string& current);
+
+        // Returns a prefetched level and its metadata. Returns nothing if it isn't ready or the mission changed since it was read.
+        Option<PrefetchedLevel> Take(const HogFile& mission, const string& name);
+
+        // Queues the textures of prefetched levels for upload. Called once per frame.
+        void Update();
+
+        // Discards prefetched levels and waits for the mission file to be released. Call before replacing the mission.
+        void Clear();
+
+        void Shutdown();
+    }
+}
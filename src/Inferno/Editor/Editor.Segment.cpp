@@ -657,12 +657,9 @@ namespace Inferno::Editor {
     }
 
     SegID FindContainingSegment(Level& level, const Vector3& point) {
-        for (int id = 0; id < level.Segments.size(); id++) {
-            auto& seg = level.GetSegment((SegID)id);
-            if (Vector3::Distance(seg.Center, point) > 200) continue;
-
-            if (PointInSegment(level, (SegID)id, point))
-                return (SegID)id;
+        for (auto& id : level.GetSegmentGrid().FindInRadius(point, 200)) {
+            if (PointInSegment(level, id, point))
+                return id;
         }
 
         return SegID::None;
@@ -860,16 +857,233 @@ namespace Inferno::Editor {
         return { newSeg, newSide };
     }
 
+    // Deletes many segments at once. Rather than removing them one by one and shifting
+    // every reference in the level for each, a single old -> new id table is built
+    // and each reference table is rewritten once.
     void DeleteSegments(Level& level, span<SegID> ids) {
-        // Must be deleted in descending order to prevent later ids becoming invalid
-        Seq::sortDescending(ids);
+        const auto segCount = (int)level.Segments.size();
+        List<bool> doomed(segCount);
+        int doomedCount = 0;
+
+        for (auto& id : ids) {
+            if (!level.SegmentExists(id) || doomed[(int)id]) continue;
+            doomed[(int)id] = true;
+            doomedCount++;
+        }
+
+        if (doomedCount == 0) return;
+
+        if (doomedCount >= segCount) {
+            // don't delete the last segment
+            doomed[0] = false;
+            doomedCount--;
+            if (doomedCount == 0) return;
+        }
+
+        auto IsDoomed = [&](SegID id) {
+            return (int)id >= 0 && (int)id < segCount && doomed[(int)id];
+        };
+
+        // Old segment id -> new segment id. None for deleted segments.
+        List<SegID> remap(segCount, SegID::None);
+        {
+            int16 next = 0;
+            for (int i = 0; i < segCount; i++) {
+                if (!doomed[i]) remap[i] = SegID(next++);
+            }
+        }
+
+        // Leaves special ids such as None and Exit untouched
+        auto Remap = [&](SegID id) {
+            if ((int)id < 0 || (int)id >= segCount) return id;
+            return remap[(int)id];
+        };
+
+        // Matcens
+        {
+            List<MatcenID> matcenRemap(level.Matcens.size(), MatcenID::None);
+            List<bool> removeMatcen(level.Matcens.size());
+
+            for (int i = 0; i < segCount; i++) {
+                auto matcen = (int)level.Segments[i].Matcen;
+                if (doomed[i] && level.Segments[i].Matcen != MatcenID::None && matcen < removeMatcen.size())
+                    removeMatcen[matcen] = true;
+            }
+
+            List<Matcen> matcens;
+            for (int i = 0; i < level.Matcens.size(); i++) {
+                if (removeMatcen[i]) continue;
+                matcenRemap[i] = MatcenID(matcens.size());
+                auto& m = matcens.emplace_back(level.Matcens[i]);
+                m.Segment = Remap(m.Segment);
+            }
+
+            for (auto& seg : level.Segments) {
+                if (seg.Matcen != MatcenID::None && (int)seg.Matcen < matcenRemap.size())
+                    seg.Matcen = matcenRemap[(int)seg.Matcen];
+            }
+
+            level.Matcens = std::move(matcens);
+        }
+
+        // Objects
+        {
+            auto removed = std::erase_if(level.Objects, [&](const Object& obj) { return IsDoomed(obj.Segment); });
+            for (auto& obj : level.Objects)
+                obj.Segment = Remap(obj.Segment);
+
+            if (removed > 0) Events::ObjectsChanged();
+        }
+
+        // Walls on deleted segments and walls on sides connected to them
+        List<bool> removeWall(level.Walls.size());
+        Set<Tag> removedWallTags;
+
+        for (int i = 0; i < segCount; i++) {
+            auto& seg = level.Segments[i];
+
+            for (auto& sideId : SideIDs) {
+                auto wall = (int)seg.GetSide(sideId).Wall;
+                if (!Seq::inRange(level.Walls, wall)) continue;
+
+                if (doomed[i] || IsDoomed(seg.GetConnection(sideId))) {
+                    removeWall[wall] = true;
+                    removedWallTags.insert(level.Walls[wall].Tag);
+                }
+            }
+        }
+
+        // Triggers owned by removed walls
+        List<bool> removeTrigger(level.Triggers.size());
+        for (int i = 0; i < level.Walls.size(); i++) {
+            auto trigger = (int)level.Walls[i].Trigger;
+            if (removeWall[i] && Seq::inRange(level.Triggers, trigger))
+                removeTrigger[trigger] = true;
+        }
+
+        auto RemapTargets = [&](ResizeArray<Tag, MAX_TRIGGER_TARGETS>& targets) {
+            for (int t = (int)targets.Count() - 1; t >= 0; t--) {
+                auto& target = targets[t];
+                if (IsDoomed(target.Segment) || removedWallTags.contains(target))
+                    targets.Remove(t);
+            }
+
+            for (auto& target : targets)
+                target.Segment = Remap(target.Segment);
+        };
+
+        List<TriggerID> triggerRemap(level.Triggers.size(), TriggerID::None);
+        {
+            List<Trigger> triggers;
+            for (int i = 0; i < level.Triggers.size(); i++) {
+                if (removeTrigger[i]) continue;
+                triggerRemap[i] = TriggerID(triggers.size());
+                auto& trigger = triggers.emplace_back(level.Triggers[i]);
+                RemapTargets(trigger.Targets);
+            }
+
+            level.Triggers = std::move(triggers);
+        }
+
+        RemapTargets(level.ReactorTriggers);
+
+        auto RemapTrigger = [&](TriggerID id) {
+            if (id == TriggerID::None || (int)id >= triggerRemap.size()) return id;
+            return triggerRemap[(int)id];
+        };
+
+        List<WallID> wallRemap(level.Walls.size(), WallID::None);
+        {
+            List<Wall> walls;
+            for (int i = 0; i < level.Walls.size(); i++) {
+                if (removeWall[i]) continue;
+                wallRemap[i] = WallID(walls.size());
+                walls.push_back(level.Walls[i]);
+            }
+
+            for (auto& wall : walls) {
+                wall.Tag.Segment = Remap(wall.Tag.Segment);
+                wall.Trigger = RemapTrigger(wall.Trigger);
+                wall.ControllingTrigger = RemapTrigger(wall.ControllingTrigger);
 
-        for (auto& segId : ids) {
-            DeleteSegment(level, segId);
-            Editor::Marked.RemoveSegment(segId);
+                if (wall.LinkedWall != WallID::None && (int)wall.LinkedWall < wallRemap.size())
+                    wall.LinkedWall = wallRemap[(int)wall.LinkedWall];
+            }
+
+            if (!removedWallTags.empty()) Events::LevelChanged();
+            level.Walls = std::move(walls);
         }
 
-        PruneVertices(Game::Level);
+        // Segment connections and wall ids
+        for (int i = 0; i < segCount; i++) {
+            if (doomed[i]) continue;
+            auto& seg = level.Segments[i];
+
+            for (auto& conn : seg.Connections)
+                conn = IsDoomed(conn) ? SegID::None : Remap(conn);
+
+            for (auto& side : seg.Sides) {
+                if (side.Wall != WallID::None && (int)side.Wall < wallRemap.size())
+                    side.Wall = wallRemap[(int)side.Wall];
+            }
+        }
+
+        // Light deltas. Lights on deleted segments are removed along with their deltas.
+        {
+            List<LightDeltaIndex> indices;
+            List<LightDelta> deltas;
+            deltas.reserve(level.LightDeltas.size());
+
+            for (auto& index : level.LightDeltaIndices) {
+                if (IsDoomed(index.Tag.Segment)) continue;
+
+                LightDeltaIndex newIndex = index;
+                newIndex.Tag.Segment = Remap(index.Tag.Segment);
+                newIndex.Index = (int16)deltas.size();
+                newIndex.Count = 0;
+
+                for (int i = 0; i < index.Count; i++) {
+                    if (!Seq::inRange(level.LightDeltas, index.Index + i)) break;
+                    auto delta = level.LightDeltas[index.Index + i];
+                    if (IsDoomed(delta.Tag.Segment)) continue;
+
+                    delta.Tag.Segment = Remap(delta.Tag.Segment);
+                    deltas.push_back(delta);
+                    newIndex.Count++;
+                }
+
+                indices.push_back(newIndex);
+            }
+
+            level.LightDeltaIndices = std::move(indices);
+            level.LightDeltas = std::move(deltas);
+        }
+
+        // Flickering lights
+        std::erase_if(level.FlickeringLights, [&](const FlickeringLight& light) { return IsDoomed(light.Tag.Segment); });
+        for (auto& light : level.FlickeringLights)
+            light.Tag.Segment = Remap(light.Tag.Segment);
+
+        if (IsDoomed(level.SecretExitReturn))
+            level.SecretExitReturn = SegID(0);
+        else
+            level.SecretExitReturn = Remap(level.SecretExitReturn);
+
+        Editor::Marked.RemoveSegments(remap);
+
+        // Compact the segments
+        {
+            List<Segment> segments;
+            segments.reserve(segCount - doomedCount);
+            for (int i = 0; i < segCount; i++) {
+                if (!doomed[i]) segments.push_back(std::move(level.Segments[i]));
+            }
+
+            level.Segments = std::move(segments);
+        }
+
+        Events::SegmentsChanged();
+        PruneVertices(level);
     }
 
     // Returns any faces that are not connected to any other segments in the input
@@ -2,6 +2,7 @@
 #include "Editor.h"
 #include "Graphics/Render.h"
 #include "Editor.Segment.h"
+#include "Bvh.h"
 
 namespace Inferno::Editor {
     // Returns true if textures match according to selection settings
@@ -18,51 +19,117 @@ namespace Inferno::Editor {
         return true;
     }
 
-    List<SelectionHit> HitTestSegments(Level& level, const Ray& ray, bool includeInvisible, SelectionMode mode) {
-        List<SelectionHit> hits;
-        int segid = 0;
-        for (auto& seg : level.Segments) {
-            for (auto& side : SideIDs) {
-                if (!includeInvisible) {
-                    bool visibleWall = false;
-                    if (auto wall = level.TryGetWall(seg.Sides[(int)side].Wall))
-                        visibleWall = Settings::Editor.EnableWallMode || wall->Type != WallType::FlyThroughTrigger;
+    // Acceleration structures for picking faces and objects.
+    // Refit when geometry moves and rebuilt when the number of segments or objects changes.
+    namespace {
+        Bvh FaceTree, ObjectTree;
+        List<Bvh::Bounds> FaceBounds, ObjectBounds;
+        bool RefitPicking = true, RebuildPicking = true;
 
-                    if (seg.SideHasConnection(side) && !visibleWall) continue;
-                }
+        void UpdateFaceBounds(Level& level) {
+            FaceBounds.resize(level.Segments.size() * 6);
+
+            for (int segid = 0; segid < level.Segments.size(); segid++) {
+                auto& seg = level.Segments[segid];
 
-                auto face = Face::FromSide(level, seg, side);
-                float dist;
-                if (face.Intersects(ray, dist) && dist >= Render::Camera.NearClip) {
-                    auto intersect = ray.position + dist * ray.direction;
-                    int16 edge = 0;
-                    if (mode == SelectionMode::Point)
-                        // find the point on this face closest to the intersect
-                        edge = face.GetClosestPoint(intersect);
-                    else
-                        edge = face.GetClosestEdge(intersect);
-
-                    hits.push_back({ { SegID(segid), side }, edge, face.Side.AverageNormal, dist });
+                for (int side = 0; side < 6; side++) {
+                    auto& bounds = FaceBounds[segid * 6 + side] = {};
+                    for (auto& i : seg.GetVertexIndices(SideID(side))) {
+                        if (auto v = level.TryGetVertex(i))
+                            bounds.Expand(*v);
+                    }
                 }
             }
+        }
+
+        void UpdateObjectBounds(const Level& level) {
+            ObjectBounds.resize(level.Objects.size());
 
-            segid++;
+            for (int id = 0; id < level.Objects.size(); id++) {
+                auto& obj = level.Objects[id];
+                auto& bounds = ObjectBounds[id] = {};
+                bounds.Expand(obj.Position - Vector3(obj.Radius));
+                bounds.Expand(obj.Position + Vector3(obj.Radius));
+            }
         }
 
+        void UpdatePicking(Level& level) {
+            // Defensive check for count changes that didn't raise an event
+            if (FaceTree.ItemCount() != level.Segments.size() * 6 ||
+                ObjectTree.ItemCount() != level.Objects.size())
+                RebuildPicking = true;
+
+            if (RebuildPicking) {
+                UpdateFaceBounds(level);
+                UpdateObjectBounds(level);
+                FaceTree.Build(FaceBounds);
+                ObjectTree.Build(ObjectBounds);
+            }
+            else if (RefitPicking) {
+                UpdateFaceBounds(level);
+                UpdateObjectBounds(level);
+                FaceTree.Refit(FaceBounds);
+                ObjectTree.Refit(ObjectBounds);
+            }
+
+            RebuildPicking = RefitPicking = false;
+        }
+
+        Tag FaceTreeItemToTag(int item) { return { SegID(item / 6), SideID(item % 6) }; }
+    }
+
+    void InvalidatePicking(bool rebuild) {
+        RefitPicking = true;
+        if (rebuild) RebuildPicking = true;
+    }
+
+    List<SelectionHit> HitTestSegments(Level& level, const Ray& ray, bool includeInvisible, SelectionMode mode) {
+        UpdatePicking(level);
+        List<SelectionHit> hits;
+
+        FaceTree.Raycast(ray, Render::Camera.FarClip, [&](int item) {
+            auto tag = FaceTreeItemToTag(item);
+            auto& seg = level.GetSegment(tag.Segment);
+            auto side = tag.Side;
+
+            if (!includeInvisible) {
+                bool visibleWall = false;
+                if (auto wall = level.TryGetWall(seg.Sides[(int)side].Wall))
+                    visibleWall = Settings::Editor.EnableWallMode || wall->Type != WallType::FlyThroughTrigger;
+
+                if (seg.SideHasConnection(side) && !visibleWall) return;
+            }
+
+            auto face = Face::FromSide(level, seg, side);
+            float dist;
+            if (face.Intersects(ray, dist) && dist >= Render::Camera.NearClip) {
+                auto intersect = ray.position + dist * ray.direction;
+                int16 edge = 0;
+                if (mode == SelectionMode::Point)
+                    // find the point on this face closest to the intersect
+                    edge = face.GetClosestPoint(intersect);
+                else
+                    edge = face.GetClosestEdge(intersect);
+
+                hits.push_back({ tag, edge, face.Side.AverageNormal, dist });
+            }
+        });
+
         // Sort by depth
         Seq::sortBy(hits, [](auto& a, auto& b) { return a.Distance < b.Distance; });
         return hits;
     }
 
-    List<SelectionHit> HitTestObjects(const Level& level, const Ray& ray) {
+    List<SelectionHit> HitTestObjects(Level& level, const Ray& ray) {
+        UpdatePicking(level);
         List<SelectionHit> hits;
 
-        for (int id = 0; id < level.Objects.size(); id++) {
+        ObjectTree.Raycast(ray, Render::Camera.FarClip, [&](int id) {
             auto& obj = level.Objects[id];
             auto sphere = DirectX::BoundingSphere(obj.Position, obj.Radius);
             if (float dist; ray.Intersects(sphere, dist))
                 hits.push_back({ .Distance = dist, .Object = ObjID(id) });
-        }
+        });
 
         return hits;
     }
@@ -619,6 +686,24 @@ namespace Inferno::Editor {
         return a < c ? (a < b) && (b < c) : (c < b) && (b < a);
     }
 
+    // Returns a frustum enclosing the screen space rectangle between p0 and p1
+    DirectX::BoundingFrustum GetWindowFrustum(Vector2 p0, Vector2 p1, const Camera& camera) {
+        auto frustum = camera.GetFrustum();
+        auto& proj = camera.Projection;
+        if (proj._44 != 0 || proj._11 == 0 || proj._22 == 0)
+            return frustum; // not a perspective projection
+
+        // Convert the screen coordinates to view space slopes
+        auto SlopeX = [&](float x) { return (2 * x / camera.Viewport.width - 1) / proj._11; };
+        auto SlopeY = [&](float y) { return (1 - 2 * y / camera.Viewport.height) / proj._22; };
+
+        frustum.LeftSlope = SlopeX(std::min(p0.x, p1.x));
+        frustum.RightSlope = SlopeX(std::max(p0.x, p1.x));
+        frustum.TopSlope = SlopeY(std::min(p0.y, p1.y));
+        frustum.BottomSlope = SlopeY(std::max(p0.y, p1.y));
+        return frustum;
+    }
+
     void MultiSelection::UpdateFromWindow(Level& level, Vector2 p0, Vector2 p1, const Camera& camera) {
         auto MarkOrUnmark = [&](const Vector3& pos, auto&& collection, auto val) {
             if (Between(p0.x, pos.x, p1.x) && Between(p0.y, pos.y, p1.y)) {
@@ -630,12 +715,18 @@ namespace Inferno::Editor {
         };
 
         auto frustum = camera.GetFrustum();
+        auto windowFrustum = GetWindowFrustum(p0, p1, camera);
+        UpdatePicking(level);
 
         switch (Settings::Editor.SelectionMode) {
             default:
             case SelectionMode::Segment:
             {
-                for (SegID i{}; (int)i < level.Segments.size(); i++) {
+                // Any segment with a center in the window has a face touching it
+                SegmentSet candidates;
+                FaceTree.Query(windowFrustum, [&](int item) { candidates.insert(FaceTreeItemToTag(item).Segment); });
+
+                for (auto& i : candidates) {
                     auto& seg = level.GetSegment(i);
                     if (!frustum.Contains(seg.Center)) continue;
                     auto vscreen = camera.Project(seg.Center, Matrix::Identity);
@@ -645,24 +736,23 @@ namespace Inferno::Editor {
             }
             case SelectionMode::Face:
             {
-                for (SegID i{}; (int)i < level.Segments.size(); i++) {
-                    auto& seg = level.GetSegment(i);
-
-                    for (auto& side : SideIDs) {
-                        auto face = Face::FromSide(level, seg, side);
-                        if (!frustum.Contains(face.Center())) continue;
-                        auto vscreen = camera.Project(face.Center(), Matrix::Identity);
-                        MarkOrUnmark(vscreen, Faces, Tag{ i, side });
-                    }
-                }
+                FaceTree.Query(windowFrustum, [&](int item) {
+                    auto tag = FaceTreeItemToTag(item);
+                    auto face = Face::FromSide(level, tag);
+                    if (!frustum.Contains(face.Center())) return;
+                    auto vscreen = camera.Project(face.Center(), Matrix::Identity);
+                    MarkOrUnmark(vscreen, Faces, tag);
+                });
                 break;
             }
             case SelectionMode::Edge:
             case SelectionMode::Point:
             {
+                // Test the vertex list directly so vertices not used by any segment can still be selected.
+                // The window frustum rejects most vertices before projecting them.
                 for (PointID i = 0; i < level.Vertices.size(); i++) {
                     auto& v = level.Vertices[i];
-                    if (!frustum.Contains(v)) continue;
+                    if (!windowFrustum.Contains(v) || !frustum.Contains(v)) continue;
                     auto vscreen = camera.Project(v, Matrix::Identity);
                     MarkOrUnmark(vscreen, Points, i);
                 }
@@ -670,13 +760,13 @@ namespace Inferno::Editor {
             }
             case SelectionMode::Object:
             {
-                for (int i = 0; i < level.Objects.size(); i++) {
+                ObjectTree.Query(windowFrustum, [&](int i) {
                     auto& obj = level.Objects[i];
                     auto pos = obj.Position;
-                    if (!frustum.Contains(pos)) continue;
+                    if (!frustum.Contains(pos)) return;
                     auto vscreen = camera.Project(pos, Matrix::Identity);
                     MarkOrUnmark(vscreen, Objects, (ObjID)i);
-                }
+                });
                 break;
             }
         }
@@ -794,8 +884,8 @@ namespace Inferno::Editor {
         }
     }
 
-    void MarkCoplanar(Level& level, Tag tag, bool toggle, Set<Tag>& marked) {
-        Set<Tag> visited; // only visit each side once
+    void MarkCoplanar(Level& level, Tag tag, bool toggle, SideSet& marked) {
+        SideSet visited; // only visit each side once
         Stack<Tag> search;
         search.push(tag);
 
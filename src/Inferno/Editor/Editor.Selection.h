@@ -2,6 +2,7 @@
 #include "Settings.h"
 #include "Types.h"
 #include "Level.h"
+#include "DenseSet.h"
 #include "Events.h"
 #include "Camera.h"
 #include "Command.h"
@@ -126,9 +127,9 @@ namespace Inferno::Editor {
 
         List<SegID> GetSegments(const Level&) const;
 
-        Set<Tag> Faces;
-        Set<SegID> Segments;
-        Set<PointID> Points;
+        SideSet Faces;
+        SegmentSet Segments;
+        PointSet Points;
         Set<ObjID> Objects;
 
         bool operator==(const MultiSelection& rhs) const {
@@ -243,6 +244,22 @@ namespace Inferno::Editor {
             Points.clear(); // this is too hard to deal with
         }
 
+        // Adjusts remaining selection after removing many segments.
+        // Remap maps old segment ids to new ones and is None for removed segments.
+        void RemoveSegments(span<const SegID> remap) {
+            auto faces = Seq::ofSet(Faces);
+            Faces.clear();
+
+            for (auto& face : faces) {
+                if (!Seq::inRange(remap, (int)face.Segment)) continue;
+                auto seg = remap[(int)face.Segment];
+                if (seg == SegID::None) continue; // don't add faces from deleted segments
+                Faces.insert({ seg, face.Side });
+            }
+
+            Points.clear();
+        }
+
         void MarkAll();
         void InvertMarked();
 
@@ -283,6 +300,10 @@ namespace Inferno::Editor {
         return faces;
     }
 
+    // Flags the picking acceleration structures for a refit on the next query.
+    // Rebuild is necessary when segments or objects are added or removed.
+    void InvalidatePicking(bool rebuild = false);
+
     // Executes a function on each valid marked object
     void ForMarkedObjects(std::function<void(Object&)> fn);
 
@@ -236,7 +236,7 @@ namespace Inferno::Editor {
     }
 
     void AlignMarked(Level& level, Tag start, span<Tag> faces, bool resetUvs) {
-        Set<Tag> visited; // only visit each face once
+        SideSet visited; // only visit each face once
         Stack<Tag> search;
         search.push(start);
 
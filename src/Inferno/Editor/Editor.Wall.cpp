@@ -298,7 +298,7 @@ namespace Inferno::Editor {
         return TriggerFlagD1::OpenDoor;
     }
 
-    void SetupTriggerOnWall(Level& level, WallID wallId, Set<Tag> targets) {
+    void SetupTriggerOnWall(Level& level, WallID wallId, const SideSet& targets) {
         TriggerID tid{};
 
         if (level.IsDescent1()) {
@@ -15,6 +15,7 @@
 #include "Convert.h"
 #include "LevelSettings.h"
 #include "Editor.IO.h"
+#include "Editor.Prefetch.h"
 #include "Version.h"
 #include "Game.Segment.h"
 #include "Graphics/Render.Particles.h"
@@ -279,6 +280,8 @@ namespace Inferno::Editor {
         if (ImGui::GetTopMostPopupModal()) return;
 
         CheckForMouselook();
+        UpdateLighting(Game::Level);
+        LevelPrefetch::Update();
 
         auto& level = Game::Level;
         auto& io = ImGui::GetIO();
@@ -391,6 +394,7 @@ namespace Inferno::Editor {
     }
 
     void ExportBitmap(LevelTexID id) {
+        List<Palette::Color> colors;
         auto& lti = Resources::GetLevelTextureInfo(id);
         if (lti.EffectClip != EClipID::None) {
             auto& eclip = Resources::GetEffectClip(lti.EffectClip);
@@ -398,13 +402,15 @@ namespace Inferno::Editor {
                 auto& bmp = Resources::GetBitmap(frame);
                 SPDLOG_INFO("Exporting {}", bmp.Info.Name);
                 std::filesystem::remove(bmp.Info.Name + ".png");
-                lodepng::encode(bmp.Info.Name + ".png", (ubyte*)bmp.Data.data(), bmp.Info.Width, bmp.Info.Height);
+                bmp.ExpandColors(Resources::GetPalette(), colors);
+                lodepng::encode(bmp.Info.Name + ".png", (ubyte*)colors.data(), bmp.Info.Width, bmp.Info.Height);
             }
         }
         else {
             auto& bmp = Resources::GetBitmap(lti.TexID);
             SPDLOG_INFO("Exporting {}", bmp.Info.Name);
-            lodepng::encode(bmp.Info.Name + ".png", (ubyte*)bmp.Data.data(), bmp.Info.Width, bmp.Info.Height);
+            bmp.ExpandColors(Resources::GetPalette(), colors);
+            lodepng::encode(bmp.Info.Name + ".png", (ubyte*)colors.data(), bmp.Info.Width, bmp.Info.Height);
         }
         //lodepng::encode("st/" + bmp.Name + ".png", (ubyte*)bmp.Data.data(), bmp.Width, bmp.Height);
         //lodepng::encode("st/" + bmp.Name + "_st.png", (ubyte*)bmp.Mask.data(), bmp.Width, bmp.Height);
@@ -559,6 +565,12 @@ namespace Inferno::Editor {
         Events::SelectSegment += [] { Editor::Gizmo.UpdatePosition(); };
         Events::LevelChanged += [] { Editor::Gizmo.UpdatePosition(); };
 
+        Events::LevelLoaded += [] { InvalidatePicking(true); };
+        Events::SegmentsChanged += [] { InvalidatePicking(true); };
+        Events::ObjectsChanged += [] { InvalidatePicking(true); };
+        Events::SnapshotChanged += [] { InvalidatePicking(true); };
+        Events::LevelChanged += [] { InvalidatePicking(); };
+
         if (Settings::Editor.ReopenLastLevel &&
             !Settings::Editor.RecentFiles.empty() &&
             filesystem::exists(Settings::Editor.RecentFiles.front())) {
@@ -8,30 +8,34 @@ namespace Inferno::Editor {
     class DiagnosticWindow final : public WindowBase {
         List<SegmentDiagnostic> _segments;
         List<SegmentDiagnostic> _objects;
+        SegmentDiagnosticCache _cache;
         int _selection{};
         bool _showWarnings = false, _markErrors = false, _fixErrors = true, _checkDegeneracy = false;
         bool _checked = false; // user has checked the level once already
         bool _showStats = true;
     public:
         DiagnosticWindow() : WindowBase("Diagnostics", &Settings::Editor.Windows.Diagnostics) {
-            auto onLevelChanged = [this] { if (IsOpen() && _checked) CheckLevel(_fixErrors); };
+            // Rechecks only the segments that changed so the results stay live while editing
+            auto onLevelChanged = [this] { if (IsOpen() && _checked) CheckLevel(_fixErrors, true); };
             Events::SegmentsChanged += onLevelChanged;
             Events::ObjectsChanged += onLevelChanged;
             Events::SnapshotChanged += [this] {
-                if (IsOpen() && _checked) CheckLevel(false);
+                if (IsOpen() && _checked) CheckLevel(false, true);
             };
 
             Events::LevelLoaded += [this] {
                 _checked = false;
                 _segments.clear();
                 _objects.clear();
+                _cache.Clear();
             };
         }
 
     protected:
-        void CheckLevel(bool fixErrors) {
+        void CheckLevel(bool fixErrors, bool incremental = false) {
             _checked = true;
-            _segments = CheckSegments(Game::Level, fixErrors, _checkDegeneracy);
+            if (!incremental) _cache.Clear();
+            _segments = CheckSegments(Game::Level, fixErrors, _checkDegeneracy, &_cache);
             _objects = CheckObjects(Game::Level);
 
             if (_markErrors) {
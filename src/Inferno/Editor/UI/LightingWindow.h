@@ -91,8 +91,11 @@ namespace Inferno::Editor {
                 ImGui::Checkbox("Occlusion", &settings.EnableOcclusion);
                 ImGui::HelpMarker("Causes level geometry to block light");
                 ImGui::SameLine();
+                ImGui::Checkbox("Adaptive", &settings.AdaptiveOcclusion);
+                ImGui::HelpMarker("Tests the center and corners of each side first and only\ntests every sample when they disagree. Much faster on large levels,\nbut thin occluders inside a side can be missed.");
+                ImGui::SameLine();
                 ImGui::Checkbox("Accurate Volumes", &settings.AccurateVolumes);
-                ImGui::HelpMarker("Calculates light on connected sides to improve volumetric accuracy.\nHas a high calculation time impact.");
+                ImGui::HelpMarker("Samples light from connected segments to improve volumetric accuracy.");
 
                 ImGui::Checkbox("Color", &settings.EnableColor);
                 ImGui::HelpMarker("Enables colored lighting. Currently is not saved to the level\nand should only be used for screenshots.");
@@ -106,15 +109,23 @@ namespace Inferno::Editor {
             }
 
 
-            if (ImGui::Button("Light Level")) {
+            if (LightingInProgress()) {
+                if (ImGui::Button("Cancel"))
+                    Commands::CancelLighting(Game::Level);
+
+                ImGui::SameLine();
+                ImGui::ProgressBar(GetLightingProgress());
+            }
+            else if (ImGui::Button("Light Level")) {
                 Commands::LightLevel(Game::Level, settings);
-                Events::LevelChanged();
             }
 
             ImGui::Text("Time: %.3f s", (float)Metrics::LightCalculationTime / 1000000.0f);
             ImGui::Text("Ray Casts: %s", std::to_string(Metrics::RaysCast).c_str());
             ImGui::Text("Ray Hits: %s", std::to_string(Metrics::RayHits).c_str());
             ImGui::Text("Cache hits: %s", std::to_string(Metrics::CacheHits).c_str());
+            ImGui::Text("Transfers reused: %s", std::to_string(Metrics::TransferHits).c_str());
+            ImGui::Text("Cached lights: %s", std::to_string(Metrics::CachedLights).c_str());
 
             ToggleLight();
 #ifdef _DEBUG
@@ -131,10 +131,13 @@ namespace Inferno::Editor {
                     }
                 }
                 else if (selectedGame == 2) {
-                    for (int i = 0; i < Resources::GameTable.Sounds.size(); i++) {
-                        auto& sound = Resources::GameTable.Sounds[i];
+                    auto names = Resources::GameTable.SoundNames();
 
-                        auto label = fmt::format("{}: {} ({})", i, sound.Name, sound.FileName);
+                    for (int i = 0; i < names.size(); i++) {
+                        auto sound = Resources::GameTable.FindSound(names[i]);
+                        if (!sound) continue;
+
+                        auto label = fmt::format("{}: {} ({})", i, sound->Name, sound->FileName);
 
                         if (!searchstr.empty()) {
                             if (!String::Contains(String::ToLower(label), searchstr))
@@ -144,11 +147,11 @@ namespace Inferno::Editor {
                         if (ImGui::Selectable(label.c_str(), i == _selection)) {
                             _selection = i;
                             if (_3d) {
-                                s.Resource = { .D3 = sound.FileName };
+                                s.Resource = { .D3 = sound->FileName };
                                 Sound::Play(s);
                             }
                             else {
-                                Sound::Play({ .D3 = sound.FileName }, _vol, _pan, _pitch);
+                                Sound::Play({ .D3 = sound->FileName }, _vol, _pan, _pitch);
                             }
                         }
                     }
@@ -5,6 +5,7 @@
 #include "Game.h"
 #include "Settings.h"
 #include "Convert.h"
+#include <ShlObj.h>
 
 Inferno::List<Inferno::ubyte> Inferno::File::ReadAllBytes(const std::filesystem::path& path) {
     std::ifstream file(path, std::ios::binary);
@@ -46,6 +47,17 @@ namespace Inferno::FileSystem {
         return Directories;
     }
 
+    filesystem::path GetCacheDirectory() {
+        PWSTR localAppData = nullptr;
+        filesystem::path path = "cache";
+
+        if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &localAppData)))
+            path = filesystem::path(localAppData) / "Inferno" / "cache";
+
+        CoTaskMemFree(localAppData);
+        return path;
+    }
+
     void Init() {
         Directories.clear();
 
@@ -17,4 +17,8 @@ namespace Inferno::FileSystem {
     Option<std::filesystem::path> TryFindFile(const std::filesystem::path&);
     filesystem::path FindFile(const std::filesystem::path&);
     span<filesystem::path> GetDirectories();
+
+    // Returns the per-user folder for generated caches, %LOCALAPPDATA%/Inferno/cache.
+    // Falls back to a cache folder in the working directory.
+    filesystem::path GetCacheDirectory();
 }
@@ -182,13 +182,20 @@ namespace Inferno::Render {
                     loadedST = material.Textures[Material2D::SuperTransparency].LoadDDS(batch, *path);
         }
 
+        // Expand the indexed bitmap into scratch buffers. Uploads copy the data, so the buffers are reused.
+        thread_local List<Palette::Color> scratch;
+
         if (!loadedDiffuse) {
-            material.Textures[Material2D::Diffuse].Load(batch, upload.Bitmap->Data.data(), upload.Bitmap->Info.Width, upload.Bitmap->Info.Height, Convert::ToWideString(upload.Bitmap->Info.Name));
+            upload.Bitmap->ExpandColors(Resources::GetPalette(), scratch);
+            material.Textures[Material2D::Diffuse].Load(batch, scratch.data(), upload.Bitmap->Info.Width, upload.Bitmap->Info.Height, Convert::ToWideString(upload.Bitmap->Info.Name));
         }
 
         // todo: optimize by putting all materials into a dictionary or some other way of not reloading special maps
-        if (!loadedST && upload.SuperTransparent)
-            material.Textures[Material2D::SuperTransparency].Load(batch, upload.Bitmap->Mask.data(), upload.Bitmap->Info.Width, upload.Bitmap->Info.Height, Convert::ToWideString(upload.Bitmap->Info.Name));
+        if (!loadedST && upload.SuperTransparent) {
+            upload.Bitmap->ExpandMask(scratch);
+            if (!scratch.empty())
+                material.Textures[Material2D::SuperTransparency].Load(batch, scratch.data(), upload.Bitmap->Info.Width, upload.Bitmap->Info.Height, Convert::ToWideString(upload.Bitmap->Info.Name));
+        }
 
         if (auto path = FileSystem::TryFindFile(baseName + "_e.DDS"))
             material.Textures[Material2D::Emissive].LoadDDS(batch, *path);
@@ -398,16 +405,22 @@ namespace Inferno::Render {
     void MaterialLibrary::LoadOutrageModel(const Outrage::Model& model) {
         Render::Adapter->WaitForGpu();
 
+        List<string> names;
+        for (auto& texture : model.Textures) {
+            if (!_outrageMaterials.contains(texture) && !Seq::contains(names, texture)) // skip loaded
+                names.push_back(texture);
+        }
+
+        // Decode on worker threads, then upload in order
+        auto bitmaps = Resources::ReadOutrageBitmaps(names);
+
         List<Material2D> uploads;
         auto batch = BeginTextureUpload();
 
-        for (auto& texture : model.Textures) {
-            if (_outrageMaterials.contains(texture)) continue; // skip loaded
-
-            MaterialUpload upload;
-            if (auto bitmap = Resources::ReadOutrageBitmap(texture))
+        for (size_t i = 0; i < names.size(); i++) {
+            if (auto& bitmap = bitmaps[i])
                 if (auto material = UploadOutrageMaterial(batch, *bitmap, _black)) {
-                    material->Name = texture; // Name in the model can be different than file name
+                    material->Name = names[i]; // Name in the model can be different than file name
                     uploads.emplace_back(std::move(material.value()));
                 }
         }
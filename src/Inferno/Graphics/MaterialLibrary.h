@@ -114,4 +114,7 @@ namespace Inferno::Render {
     inline Ptr<MaterialLibrary> Materials;
 
     Set<TexID> GetLevelSegmentTextures(const Level& level);
+
+    // Returns the textures used by a level's segments, objects and effects
+    Set<TexID> GetLevelTextures(const Level& level, bool preloadDoors);
 }
\ No newline at end of file
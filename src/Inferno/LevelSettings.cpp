@@ -2,6 +2,7 @@
 #include "LevelSettings.h"
 #include "Yaml.h"
 #include "Resources.h"
+#include <charconv>
 
 using namespace Yaml;
 
@@ -164,16 +165,114 @@ namespace Inferno {
         }
     }
 
-    void LoadLevelMetadata(Level& level, const string& data) {
+    // Packs the accumulated light of a bake into bytes
+    List<ubyte> PackLightBake(const LightBake& bake) {
+        constexpr size_t entrySize = sizeof(int16) * 2 + sizeof(SideLighting);
+        List<ubyte> data(sizeof(uint32) + bake.Accumulated.size() * entrySize);
+        auto dest = data.data();
+
+        auto write = [&dest](const auto& value) {
+            memcpy(dest, &value, sizeof(value));
+            dest += sizeof(value);
+        };
+
+        write((uint32)bake.Accumulated.size());
+
+        for (auto& [tag, light] : bake.Accumulated) {
+            write((int16)tag.Segment);
+            write((int16)tag.Side);
+            write(light);
+        }
+
+        return data;
+    }
+
+    // Returns false if the data is truncated or refers to sides that aren't in the level
+    bool UnpackLightBake(span<const ubyte> data, const Level& level, LightBake& bake) {
+        constexpr size_t entrySize = sizeof(int16) * 2 + sizeof(SideLighting);
+        auto src = data.data();
+        auto end = src + data.size();
+
+        auto read = [&](auto& value) {
+            if (src + sizeof(value) > end) return false;
+            memcpy(&value, src, sizeof(value));
+            src += sizeof(value);
+            return true;
+        };
+
+        uint32 count = 0;
+        if (!read(count)) return false;
+        if ((uint64)count * entrySize > (uint64)(end - src)) return false; // count doesn't fit in the data
+        bake.Accumulated.resize(count);
+
+        for (auto& [tag, light] : bake.Accumulated) {
+            int16 seg = 0, side = 0;
+            if (!read(seg) || !read(side) || !read(light)) return false;
+            tag = { SegID(seg), SideID(side) };
+            if (!level.SegmentExists(tag) || side < 0 || side >= 6) return false;
+        }
+
+        return true;
+    }
+
+    void SaveLightBakes(ryml::NodeRef node, const Level& level) {
+        node |= ryml::SEQ;
+        if (!level.LightBakes) return;
+
+        // Write in tag order so saving an unchanged level produces the same file
+        List<const Tuple<const Tag, LightBake>*> bakes;
+        bakes.reserve(level.LightBakes->size());
+        for (auto& entry : *level.LightBakes)
+            bakes.push_back(&entry);
+
+        Seq::sortBy(bakes, [](auto a, auto b) { return a->first < b->first; });
+
+        for (auto& entry : bakes) {
+            auto& [source, bake] = *entry;
+            auto child = node.append_child();
+            child |= ryml::MAP;
+            child["Tag"] << EncodeTag(source);
+            child["Hash"] << fmt::format("{:016x}", bake.Hash);
+            child["Data"] << String::EncodeBase64(PackLightBake(bake));
+        }
+    }
+
+    void ReadLightBakes(ryml::NodeRef node, Level& level) {
+        if (!node.valid() || node.is_seed()) return;
+
+        auto bakes = MakeRef<Dictionary<Tag, LightBake>>();
+
+        for (const auto& child : node.children()) {
+            Tag tag;
+            ReadValue(child["Tag"], tag);
+
+            string hash, data;
+            ReadString(child["Hash"], hash);
+            ReadString(child["Data"], data);
+            if (hash.empty() || data.empty()) continue;
+
+            LightBake bake;
+            auto [ptr, ec] = std::from_chars(hash.data(), hash.data() + hash.size(), bake.Hash, 16);
+            if (ec != std::errc() || ptr != hash.data() + hash.size()) continue; // malformed hash
+
+            if (level.SegmentExists(tag) && UnpackLightBake(String::DecodeBase64(data), level, bake))
+                (*bakes)[tag] = std::move(bake);
+        }
+
+        level.LightBakes = bakes;
+    }
+
+    void LoadLevelMetadata(Level& level, const string& data, LightSettings& lighting) {
         try {
             ryml::Tree doc = ryml::parse(ryml::to_csubstr(data));
             ryml::NodeRef root = doc.rootref();
 
             if (root.is_map()) {
-                Settings::Editor.Lighting = LoadLightSettings(root["Lighting"]);
+                lighting = LoadLightSettings(root["Lighting"]);
                 ReadSegmentInfo(root["Segments"], level);
                 ReadSideInfo(root["Sides"], level);
                 ReadWallInfo(root["Walls"], level);
+                ReadLightBakes(root["LightBakes"], level);
                 ReadValue(root["CameraPosition"], level.CameraPosition);
                 ReadValue(root["CameraTarget"], level.CameraTarget);
                 ReadValue(root["CameraUp"], level.CameraUp);
@@ -184,16 +283,17 @@ namespace Inferno {
         }
     }
 
-    void SaveLevelMetadata(const Level& level, std::ostream& stream) {
+    void SaveLevelMetadata(const Level& level, std::ostream& stream, const LightSettings& lighting) {
         try {
             ryml::Tree doc(30, 128);
             doc.rootref() |= ryml::MAP;
 
             doc["Version"] << 1;
-            SaveLightSettings(doc["Lighting"], Settings::Editor.Lighting);
+            SaveLightSettings(doc["Lighting"], lighting);
             SaveSegmentInfo(doc["Segments"], level);
             SaveSideInfo(doc["Sides"], level);
             SaveWallInfo(doc["Walls"], level);
+            SaveLightBakes(doc["LightBakes"], level);
 
             if (level.CameraUp != Vector3::Zero) {
                 doc["CameraPosition"] << EncodeVector(level.CameraPosition);
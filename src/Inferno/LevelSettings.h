@@ -5,6 +5,9 @@
 #include "Level.h"
 
 namespace Inferno {
-    void LoadLevelMetadata(Level& level, const string& data);
-    void SaveLevelMetadata(const Level&, std::ostream&);  
+    constexpr auto METADATA_EXTENSION = "ied"; // inferno engine data
+
+    // Reads the level metadata (IED file). The lighting settings stored with the level are written to lighting.
+    void LoadLevelMetadata(Level& level, const string& data, LightSettings& lighting);
+    void SaveLevelMetadata(const Level&, std::ostream&, const LightSettings& lighting);
 }
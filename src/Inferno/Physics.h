@@ -1,6 +1,7 @@
 #pragma once
 #include "Level.h"
 #include "Face.h"
+#include "DenseSet.h"
 
 namespace Inferno {
     void UpdatePhysics(Level& level, double t, float dt);
@@ -25,7 +26,7 @@ namespace Inferno {
         Object* HitObj = nullptr;
         float Distance = FLT_MAX;
         Vector3 Point, Normal;
-        Set<SegID> Visited; // visited segments
+        SegmentSet Visited; // visited segments
 
         void Update(const HitInfo& hit, Object* obj) {
             if (!obj || hit.Distance > Distance) return;
@@ -3,12 +3,14 @@
 #include "FileSystem.h"
 #include "Sound.h"
 #include "Pig.h"
+#include "PigCache.h"
 #include <fstream>
 #include <mutex>
 #include "Game.h"
 #include "logging.h"
 #include "Graphics/Render.h"
 #include "Editor/Editor.Object.h"
+#include "Editor/Editor.Lighting.h"
 
 namespace Inferno::Resources {
     SoundFile SoundsD1, SoundsD2;
@@ -247,7 +249,7 @@ namespace Inferno::Resources {
 
         for (auto& entry : Pig.Entries) {
             auto& bmp = GetBitmap(entry.ID);
-            entry.AverageColor = GetAverageColor(bmp.Data);
+            entry.AverageColor = bmp.GetAverageColor(LevelPalette);
         }
         //for (auto& tid : GameData.LevelTexIdx) {
         //    auto id = LookupLevelTexID(tid);
@@ -307,6 +309,56 @@ namespace Inferno::Resources {
         throw Exception(msg);
     }
 
+    constexpr size_t MAX_PIG_CACHE_FILES = 16;
+
+    // Removes all but the most recently written files with an extension in a cache folder
+    void PruneCacheFolder(const filesystem::path& folder, const filesystem::path& extension, size_t maxFiles) {
+        List<Tuple<filesystem::file_time_type, filesystem::path>> files;
+
+        std::error_code ec;
+        for (auto& entry : filesystem::directory_iterator(folder, ec)) {
+            if (entry.path().extension() == extension)
+                files.push_back({ entry.last_write_time(ec), entry.path() });
+        }
+
+        if (files.size() <= maxFiles) return;
+
+        Seq::sortBy(files, [](auto& a, auto& b) { return a.first > b.first; });
+        for (size_t i = maxFiles; i < files.size(); i++)
+            filesystem::remove(files[i].second, ec);
+    }
+
+    // Reads all bitmaps in a pig, using the decoded bitmap cache when it is up to date.
+    // Cache files are named by key so pigs with the same name in different folders don't share one.
+    List<PigBitmap> ReadAllBitmapsCached(const PigFile& pig, const Palette& palette, span<const ubyte> paletteData) {
+        auto start = std::chrono::steady_clock::now();
+        auto elapsedMs = [&start] {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        auto key = PigCache::GetKey(pig.Path, paletteData);
+        auto folder = FileSystem::GetCacheDirectory() / "pigs";
+        auto cachePath = folder / fmt::format("{:016x}.bmc", key);
+
+        if (auto cached = PigCache::Read(cachePath, key, pig)) {
+            SPDLOG_INFO("Read {} bitmaps from cache `{}` in {:.1f} ms", cached->size(), cachePath.string(), elapsedMs());
+            return std::move(*cached);
+        }
+
+        auto bitmaps = ReadAllBitmaps(pig, palette);
+        SPDLOG_INFO("Decoded {} bitmaps in {:.1f} ms", bitmaps.size(), elapsedMs());
+
+        try {
+            PigCache::Write(cachePath, key, bitmaps);
+            PruneCacheFolder(folder, ".bmc", MAX_PIG_CACHE_FILES);
+        }
+        catch (const std::exception& e) {
+            SPDLOG_WARN("Unable to write pig cache `{}`: {}", cachePath.string(), e.what());
+        }
+
+        return bitmaps;
+    }
+
     void LoadDescent2Resources(Level& level) {
         std::scoped_lock lock(PigMutex);
         SPDLOG_INFO("Loading Descent 2 level: '{}'\r\n Version: {} Segments: {} Vertices: {}", level.Name, level.Version, level.Segments.size(), level.Vertices.size());
@@ -335,7 +387,7 @@ namespace Inferno::Resources {
 
         auto pig = ReadPigFile(pigPath);
         auto palette = ReadPalette(paletteData);
-        auto textures = ReadAllBitmaps(pig, palette);
+        auto textures = ReadAllBitmapsCached(pig, palette, paletteData);
 
         if (level.IsVertigo()) {
             auto vHog = HogFile::Read(FileSystem::FindFile(L"d2x.hog"));
@@ -460,7 +512,7 @@ namespace Inferno::Resources {
         pig.Path = path;
         sounds.Path = path;
         //ReadBitmap(pig, palette, TexID(61)); // cockpit
-        auto textures = ReadAllBitmaps(pig, palette);
+        auto textures = ReadAllBitmapsCached(pig, palette, paletteData);
 
         filesystem::path folder = level.Path;
         folder.remove_filename();
@@ -524,6 +576,8 @@ namespace Inferno::Resources {
 
     void LoadLevel(Level& level) {
         try {
+            // Background lighting reads the texture and game data that are about to be replaced
+            Editor::AbortLighting();
             ResetResources();
 
             if (level.IsDescent2()) {
@@ -611,16 +665,30 @@ namespace Inferno::Resources {
     }
 
     void LoadVClips() {
+        List<const Outrage::TextureInfo*> animated;
         for (auto& tex : GameTable.Textures) {
-            if (!tex.Animated()) continue;
-
-            if (auto r = OpenFile(tex.FileName)) {
-                auto vc = Outrage::VClip::Read(*r);
-                if (vc.Frames.size() > 0)
-                    vc.FrameTime = tex.Speed / vc.Frames.size();
-                vc.FileName = tex.FileName;
-                VClips.push_back(std::move(vc));
+            if (tex.Animated()) animated.push_back(&tex);
+        }
+
+        // Each clip decodes all of its frames, so read them in parallel and keep the table order
+        List<Option<Outrage::VClip>> clips(animated.size());
+
+        ParallelFor(animated.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                auto& tex = *animated[i];
+
+                if (auto r = OpenFile(tex.FileName)) {
+                    auto vc = Outrage::VClip::Read(*r);
+                    if (vc.Frames.size() > 0)
+                        vc.FrameTime = tex.Speed / vc.Frames.size();
+                    vc.FileName = tex.FileName;
+                    clips[i] = std::move(vc);
+                }
             }
+        }, 4);
+
+        for (auto& clip : clips) {
+            if (clip) VClips.push_back(std::move(*clip));
         }
     }
 
@@ -651,6 +719,23 @@ namespace Inferno::Resources {
         return {};
     }
 
+    List<Option<Outrage::Bitmap>> ReadOutrageBitmaps(span<const string> names) {
+        List<Option<Outrage::Bitmap>> bitmaps(names.size());
+
+        ParallelFor(names.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                try {
+                    bitmaps[i] = ReadOutrageBitmap(names[i]);
+                }
+                catch (const std::exception& e) {
+                    SPDLOG_ERROR("Error reading {}: {}", names[i], e.what());
+                }
+            }
+        }, 4);
+
+        return bitmaps;
+    }
+
     Option<Outrage::Model> ReadOutrageModel(const string& name) {
         if (auto r = OpenFile(name))
             return Outrage::Model::Read(*r);
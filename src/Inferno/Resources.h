@@ -86,6 +86,9 @@ namespace Inferno::Resources {
     Option<StreamReader> OpenFile(const string& name);
 
     Option<Outrage::Bitmap> ReadOutrageBitmap(const string& name);
+
+    // Reads and decodes several bitmaps in parallel. Results are in the same order as the names.
+    List<Option<Outrage::Bitmap>> ReadOutrageBitmaps(span<const string> names);
     Option<Outrage::Model> ReadOutrageModel(const string& name);
 
     Outrage::Model const* GetOutrageModel(const string& name);
@@ -2,6 +2,7 @@
 
 #include "Level.h"
 #include "Types.h"
+#include "DenseSet.h"
 
 namespace Inferno {
     struct Room {
@@ -16,7 +17,7 @@ namespace Inferno {
     };
 
     inline Room CreateRoom(Level& level, SegID start) {
-        Set<SegID> segments;
+        SegmentSet segments(level.Segments.size());
         Stack<SegID> search;
         search.push(start);
 
@@ -68,7 +69,7 @@ namespace Inferno {
     }
 
     inline List<Room> CreateRooms(Level& level) {
-        Set<SegID> segments;
+        SegmentSet segments(level.Segments.size());
         List<Room> rooms;
 
         Stack<SegID> search;
@@ -105,6 +105,7 @@ namespace Inferno {
         node["DistanceThreshold"] << s.DistanceThreshold;
         node["EnableColor"] << s.EnableColor;
         node["EnableOcclusion"] << s.EnableOcclusion;
+        node["AdaptiveOcclusion"] << s.AdaptiveOcclusion;
         node["Falloff"] << s.Falloff;
         node["MaxValue"] << s.MaxValue;
         node["Multiplier"] << s.Multiplier;
@@ -123,6 +124,7 @@ namespace Inferno {
         ReadValue(node["DistanceThreshold"], settings.DistanceThreshold);
         ReadValue(node["EnableColor"], settings.EnableColor);
         ReadValue(node["EnableOcclusion"], settings.EnableOcclusion);
+        ReadValue(node["AdaptiveOcclusion"], settings.AdaptiveOcclusion);
         ReadValue(node["Falloff"], settings.Falloff);
         ReadValue(node["MaxValue"], settings.MaxValue);
         ReadValue(node["Multiplier"], settings.Multiplier);
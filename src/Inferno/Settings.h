@@ -34,6 +34,7 @@ namespace Inferno {
         float Radius = 20.0f;
         float MaxValue = 1.5f;
         bool EnableOcclusion = true;
+        bool AdaptiveOcclusion = false; // Only test every sample when the center and corners disagree. Faster, but can miss thin occluders
         bool AccurateVolumes = false;
         int Bounces = 2;
         float Reflectance = 0.225f;
@@ -5,6 +5,7 @@
 #include "SoundSystem.h"
 #include "Resources.h"
 #include "Editor/Editor.h"
+#include "Editor/Editor.Batch.h"
 #include "Mission.h"
 #include "HogFile.h"
 #include "Settings.h"
@@ -181,7 +182,7 @@ void TestSegID() {
     assert(id == SegID(6));
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     // https://github.com/gabime/spdlog/wiki/3.-Custom-formatting#pattern-flags
     spdlog::set_pattern("[%M:%S.%e] [%^%l%$] [TID:%t] [%s:%#] %v");
     std::srand((uint)std::time(nullptr)); // seed c-random
@@ -195,6 +196,10 @@ int main() {
         FileSystem::Init();
         Resources::Init();
 
+        // Process a mission without creating a window
+        if (auto batch = Editor::ParseBatchArgs(argc, argv))
+            return Editor::RunBatch(*batch);
+
         shell.Show(1024, 768);
         Settings::Save();
 
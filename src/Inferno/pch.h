@@ -21,6 +21,7 @@
 #include <optional>
 #include <set>
 #include <future>
+#include <shared_mutex>
 #include <span>
 #include <queue>
 #include <ranges>